@@ -0,0 +1,226 @@
+#ifndef N_CUBE_BIT_SLICED_H_
+#define N_CUBE_BIT_SLICED_H_
+
+#include <algorithm>
+#include <bitset>
+#include <cstdint>
+#include <vector>
+
+namespace ncube {
+
+/**
+ *  A family of sets of E elements, e.g. sliceable sets of E edges, stored
+ *  bit-sliced for batch subset and superset queries.
+ *
+ *  The sets are numbered in the order they are added and stored in blocks of
+ *  block_size sets. A block holds a bit vector per element whose j-th bit
+ *  tells if the j-th set of the block contains the element. So the sets of a
+ *  block that contain all of some elements are the AND of their bit vectors,
+ *  which answers a query for block_size sets at once. Removed sets are cleared
+ *  in the alive mask of their block and skipped by all queries.
+ **/
+template <std::size_t E>
+class bit_sliced_family {
+ public:
+  using set_t = std::bitset<E>;
+  /* One bit per set, words_per_block words per block. */
+  using mask_t = std::vector<uint64_t>;
+
+  static constexpr std::size_t words_per_block = 4;
+  static constexpr std::size_t block_size = 64 * words_per_block;
+
+  /**
+   *  Adds a set and returns its number.
+   **/
+  std::size_t add(const set_t& ss) {
+    const auto i = sets_.size();
+    if (i % block_size == 0) {
+      bits_.resize(bits_.size() + E * words_per_block, 0);
+      alive_.resize(alive_.size() + words_per_block, 0);
+    }
+    sets_.push_back(ss);
+    const auto block = i / block_size;
+    const auto word = (i % block_size) / 64;
+    const uint64_t bit = uint64_t{1} << (i % 64);
+    for (std::size_t e = 0; e < E; ++e) {
+      if (ss[e]) {
+        bits_[(block * E + e) * words_per_block + word] |= bit;
+      }
+    }
+    alive_[block * words_per_block + word] |= bit;
+    ++num_alive_;
+    return i;
+  }
+
+  /**
+   *  Removes the set with the given number.
+   **/
+  void remove(std::size_t i) {
+    uint64_t& word = alive_[i / 64];
+    const uint64_t bit = uint64_t{1} << (i % 64);
+    if (word & bit) {
+      word &= ~bit;
+      --num_alive_;
+    }
+  }
+
+  /**
+   *  Adds a set unless it is a subset of a set of the family and removes the
+   *  sets that are subsets of it. Returns true if the set was added and false
+   *  otherwise.
+   **/
+  bool add_maximal(const set_t& ss) {
+    if (any_superset_of(ss)) {
+      return false;
+    }
+    const auto subsets = subsets_of(ss);
+    for (std::size_t w = 0; w < subsets.size(); ++w) {
+      for (auto word = subsets[w]; word; word &= word - 1) {
+        remove(w * 64 + static_cast<std::size_t>(__builtin_ctzll(word)));
+      }
+    }
+    // removed sets still take up space in the blocks
+    if (sets_.size() - num_alive_ > std::max<std::size_t>(num_alive_, 1024)) {
+      compact();
+    }
+    add(ss);
+    return true;
+  }
+
+  /**
+   *  Returns the sets of the family that contain all elements of a set.
+   **/
+  mask_t supersets_of(const set_t& ss) const {
+    return query(elements_of(ss, true));
+  }
+
+  /**
+   *  Returns the sets of the family that contain no element outside of a set.
+   **/
+  mask_t subsets_of(const set_t& ss) const {
+    return query(elements_of(ss, false), true);
+  }
+
+  /**
+   *  Returns the sets of the family whose union with a set contains all
+   *  elements.
+   **/
+  mask_t covers_complement_of(const set_t& ss) const {
+    return query(elements_of(ss, false));
+  }
+
+  /**
+   *  Returns true if a set of the family contains all elements of a set and
+   *  false otherwise. Stops at the first block with such a set.
+   **/
+  bool any_superset_of(const set_t& ss) const {
+    const auto elements = elements_of(ss, true);
+    for (std::size_t block = 0; block < num_blocks(); ++block) {
+      uint64_t mask[words_per_block];
+      block_query(block, elements, false, mask);
+      uint64_t any = 0;
+      for (std::size_t w = 0; w < words_per_block; ++w) {
+        any |= mask[w];
+      }
+      if (any) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   *  Returns the set with the given number.
+   **/
+  const set_t& operator[](std::size_t i) const { return sets_[i]; }
+
+  /**
+   *  Returns the sets that haven't been removed in the order they were added.
+   **/
+  std::vector<set_t> sets() const {
+    std::vector<set_t> alive_sets;
+    alive_sets.reserve(num_alive_);
+    for (std::size_t i = 0; i < sets_.size(); ++i) {
+      if (alive_[i / 64] & (uint64_t{1} << (i % 64))) {
+        alive_sets.push_back(sets_[i]);
+      }
+    }
+    return alive_sets;
+  }
+
+  /**
+   *  Returns the number of sets that haven't been removed.
+   **/
+  std::size_t size() const { return num_alive_; }
+
+ private:
+  std::size_t num_blocks() const { return alive_.size() / words_per_block; }
+
+  /**
+   *  Returns the elements that are in a set if contained is true and the
+   *  elements that aren't otherwise.
+   **/
+  static std::vector<std::size_t> elements_of(const set_t& ss,
+                                              bool contained) {
+    std::vector<std::size_t> elements;
+    for (std::size_t e = 0; e < E; ++e) {
+      if (ss[e] == contained) {
+        elements.push_back(e);
+      }
+    }
+    return elements;
+  }
+
+  /**
+   *  Computes the alive sets of a block that contain all given elements, or
+   *  none of them if negate is true.
+   **/
+  void block_query(std::size_t block, const std::vector<std::size_t>& elements,
+                   bool negate, uint64_t* mask) const {
+    const uint64_t flip = negate ? ~uint64_t{0} : 0;
+    for (std::size_t w = 0; w < words_per_block; ++w) {
+      mask[w] = alive_[block * words_per_block + w];
+    }
+    for (const auto e : elements) {
+      const uint64_t* column = bits_.data() + (block * E + e) * words_per_block;
+      for (std::size_t w = 0; w < words_per_block; ++w) {
+        mask[w] &= column[w] ^ flip;
+      }
+    }
+  }
+
+  mask_t query(const std::vector<std::size_t>& elements,
+               bool negate = false) const {
+    mask_t mask(alive_.size());
+    for (std::size_t block = 0; block < num_blocks(); ++block) {
+      block_query(block, elements, negate,
+                  mask.data() + block * words_per_block);
+    }
+    return mask;
+  }
+
+  /**
+   *  Renumbers the sets that haven't been removed.
+   **/
+  void compact() {
+    const auto alive_sets = sets();
+    sets_.clear();
+    bits_.clear();
+    alive_.clear();
+    num_alive_ = 0;
+    for (const auto& ss : alive_sets) {
+      add(ss);
+    }
+  }
+
+  std::vector<set_t> sets_;
+  // the bit vector of element e in block b starts at
+  // bits_[(b * E + e) * words_per_block]
+  std::vector<uint64_t> bits_;
+  std::vector<uint64_t> alive_;
+  std::size_t num_alive_ = 0;
+};
+
+}  // namespace ncube
+
+#endif  // N_CUBE_BIT_SLICED_H_
@@ -0,0 +1,398 @@
+#ifndef N_CUBE_CHECKPOINT_H_
+#define N_CUBE_CHECKPOINT_H_
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "set_file.hpp"
+#include "sliceable_set.hpp"
+#include "thread_pool.hpp"
+
+namespace ncube {
+
+/* The number of units of work a checkpointed scan completes at a time. */
+constexpr std::size_t checkpoint_block = 64;
+
+/* How long-running scans and stage computations are checkpointed. */
+struct checkpoint_options_t {
+  std::filesystem::path dir;  // empty if checkpointing is off
+  bool resume = false;        // continue from the checkpoints in dir
+  double flush_seconds = 60;  // the least time between two scan checkpoints
+};
+
+/* The number and cost of all checkpoint writes so far. */
+struct checkpoint_stats_t {
+  std::atomic<uint64_t> num_writes{0};
+  std::atomic<uint64_t> num_bytes{0};
+  std::atomic<uint64_t> nanoseconds{0};
+};
+
+/**
+ *  Returns the checkpoint options used by default, as requested by
+ *  configure_checkpoints.
+ **/
+checkpoint_options_t& default_checkpoint_options() {
+  static checkpoint_options_t options;
+  return options;
+}
+
+/**
+ *  Returns the statistics of all checkpoint writes.
+ **/
+checkpoint_stats_t& checkpoint_stats() {
+  static checkpoint_stats_t stats;
+  return stats;
+}
+
+/**
+ *  Sets the default checkpoint options given by the command line options
+ *  --checkpoint or --checkpoint=DIR, which write checkpoints to DIR (or else to
+ *  default_dir), --resume, which also continues from the checkpoints found
+ *  there, and --checkpoint-interval=SECONDS, which sets the least time between
+ *  two checkpoints of a scan. Has to be called before any checkpoint is used.
+ **/
+void configure_checkpoints(int argc, char* argv[],
+                           const std::filesystem::path& default_dir) {
+  auto& options = default_checkpoint_options();
+  bool enabled = false;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--checkpoint") == 0) {
+      enabled = true;
+    } else if (std::strncmp(argv[i], "--checkpoint=", 13) == 0) {
+      enabled = true;
+      options.dir = argv[i] + 13;
+    } else if (std::strcmp(argv[i], "--resume") == 0) {
+      enabled = true;
+      options.resume = true;
+    } else if (std::strncmp(argv[i], "--checkpoint-interval=", 22) == 0) {
+      options.flush_seconds = std::strtod(argv[i] + 22, nullptr);
+    }
+  }
+  if (enabled && options.dir.empty()) {
+    options.dir = default_dir;
+  }
+}
+
+/**
+ *  Prints the number, size and time of all checkpoint writes, if checkpointing
+ *  is on.
+ **/
+void report_checkpoints(std::ostream& out) {
+  if (default_checkpoint_options().dir.empty()) {
+    return;
+  }
+  const auto& stats = checkpoint_stats();
+  out << "Checkpoint writes: " << stats.num_writes << " (" << stats.num_bytes
+      << " bytes) in " << static_cast<double>(stats.nanoseconds) * 1e-9
+      << " s" << std::endl;
+}
+
+/**
+ *  Returns the path a file is written to before it replaces the file at the
+ *  given path (see replace_file).
+ **/
+std::filesystem::path temporary_path(const std::filesystem::path& path) {
+  auto tmp = path;
+  tmp += ".tmp";
+  return tmp;
+}
+
+/**
+ *  Replaces the file at the given path with the file at temporary_path(path)
+ *  and adds it to the checkpoint statistics, which start at the given time.
+ *
+ *  The new file is synced to disk before it is renamed, so the file at the
+ *  path is always either the complete old or the complete new version, even if
+ *  the program or the machine stops in between.
+ **/
+void replace_file(const std::filesystem::path& path,
+                  std::chrono::steady_clock::time_point start) {
+  const auto tmp = temporary_path(path);
+  const int fd = ::open(tmp.c_str(), O_RDONLY);
+  if (fd < 0 || ::fsync(fd) != 0) {
+    if (fd >= 0) {
+      ::close(fd);
+    }
+    throw std::runtime_error("cannot write checkpoint " + tmp.string());
+  }
+  ::close(fd);
+  const auto num_bytes = std::filesystem::file_size(tmp);
+  std::filesystem::rename(tmp, path);
+  const auto duration = std::chrono::steady_clock::now() - start;
+  auto& stats = checkpoint_stats();
+  stats.num_writes += 1;
+  stats.num_bytes += num_bytes;
+  stats.nanoseconds += static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+}
+
+/**
+ *  Writes sliceable sets to a set file at the given path as a checkpoint, see
+ *  replace_file.
+ **/
+template <int32_t N>
+void write_set_file_checkpoint(const std::vector<sliceable_set_t<N>>& sets,
+                               const std::filesystem::path& path,
+                               uint32_t flags) {
+  const auto start = std::chrono::steady_clock::now();
+  write_set_file<N>(sets, temporary_path(path), flags);
+  replace_file(path, start);
+}
+
+/**
+ *  Returns a hash of the two lists of sliceable sets of a scan, which tells
+ *  apart checkpoints of different scans.
+ **/
+template <int32_t N>
+uint64_t scan_fingerprint(const sliceable_set_t<N>* sets_1_begin,
+                          const sliceable_set_t<N>* sets_1_end,
+                          const sliceable_set_t<N>* sets_2_begin,
+                          const sliceable_set_t<N>* sets_2_end) {
+  // the sizes separate the lists, so that moving a set from one list to the
+  // other changes the hash
+  uint64_t hash = set_file_checksum<N>(sets_1_begin, sets_1_end);
+  hash = (hash ^ static_cast<uint64_t>(sets_1_end - sets_1_begin)) *
+         0x100000001b3;
+  hash = set_file_checksum<N>(sets_2_begin, sets_2_end, hash);
+  hash = (hash ^ static_cast<uint64_t>(sets_2_end - sets_2_begin)) *
+         0x100000001b3;
+  return (hash ^ static_cast<uint64_t>(N)) * 0x100000001b3;
+}
+
+/**
+ *  The progress of a scan over the units of work 0, 1, ..., e.g. the sliceable
+ *  sets of the first list of pairwise_unions_slice_cube, that is kept in a
+ *  checkpoint file.
+ *
+ *  The completed units are kept as disjoint ranges, so the checkpoint stays
+ *  small however the work is split among the threads. The checkpoint file is
+ *  written at most once every flush_seconds while work is completed, so the
+ *  share of time spent on writing it is bounded, and at most flush_seconds of
+ *  work is lost when the scan stops. A checkpoint with an empty path is never
+ *  written.
+ *
+ *  The checkpoint file is a text file with the lines "n_cube_scan 1", the
+ *  fingerprint of the scan, 1 if the scan found what it looked for and 0
+ *  otherwise, the number of ranges and a line "begin end" for every range.
+ **/
+class scan_checkpoint {
+ public:
+  using range_t = std::pair<std::size_t, std::size_t>;
+
+  /**
+   *  Starts a scan with the given fingerprint (see scan_fingerprint). If
+   *  resume is true, the progress is read from the checkpoint file, if any.
+   *  Throws if the checkpoint file belongs to another scan.
+   **/
+  scan_checkpoint(const std::filesystem::path& path, uint64_t fingerprint,
+                  bool resume, double flush_seconds)
+      : path_(path),
+        fingerprint_(fingerprint),
+        flush_seconds_(flush_seconds),
+        last_flush_(std::chrono::steady_clock::now()) {
+    if (path_.empty() || !resume || !std::filesystem::exists(path_)) {
+      return;
+    }
+    std::ifstream file(path_);
+    std::string magic;
+    int version = 0;
+    uint64_t fingerprint_read = 0;
+    std::size_t num_ranges = 0;
+    file >> magic >> version >> fingerprint_read >> found_ >> num_ranges;
+    if (!file || magic != "n_cube_scan" || version != 1) {
+      throw std::runtime_error("cannot read checkpoint " + path_.string());
+    }
+    if (fingerprint_read != fingerprint_) {
+      throw std::runtime_error("checkpoint of another scan " + path_.string());
+    }
+    for (std::size_t r = 0; r < num_ranges; ++r) {
+      std::size_t begin = 0, end = 0;
+      file >> begin >> end;
+      if (!file) {
+        throw std::runtime_error("cannot read checkpoint " + path_.string());
+      }
+      completed_.emplace(begin, end);
+    }
+  }
+
+  scan_checkpoint(const scan_checkpoint&) = delete;
+  scan_checkpoint& operator=(const scan_checkpoint&) = delete;
+
+  /**
+   *  Returns true if a completed unit found what the scan looks for.
+   **/
+  bool found() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return found_;
+  }
+
+  /**
+   *  Returns the ranges of the units in [begin, end) that aren't completed.
+   **/
+  std::vector<range_t> remaining(std::size_t begin, std::size_t end) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<range_t> ranges;
+    auto it = completed_.upper_bound(begin);
+    if (it != completed_.begin() && std::prev(it)->second > begin) {
+      --it;
+    }
+    for (; it != completed_.end() && it->first < end; ++it) {
+      if (it->first > begin) {
+        ranges.emplace_back(begin, it->first);
+      }
+      begin = std::max(begin, it->second);
+    }
+    if (begin < end) {
+      ranges.emplace_back(begin, end);
+    }
+    return ranges;
+  }
+
+  /**
+   *  Marks the units in [begin, end) as completed, where found tells if they
+   *  found what the scan looks for, and writes the checkpoint file if it is
+   *  due.
+   **/
+  void complete(std::size_t begin, std::size_t end, bool found) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    found_ = found_ || found;
+    // merge with the overlapping and adjacent ranges
+    auto it = completed_.upper_bound(begin);
+    if (it != completed_.begin() && std::prev(it)->second >= begin) {
+      --it;
+      begin = it->first;
+    }
+    while (it != completed_.end() && it->first <= end) {
+      end = std::max(end, it->second);
+      it = completed_.erase(it);
+    }
+    completed_.emplace(begin, end);
+    const std::chrono::duration<double> since_flush =
+        std::chrono::steady_clock::now() - last_flush_;
+    if (found || since_flush.count() >= flush_seconds_) {
+      flush_locked();
+    }
+  }
+
+  /**
+   *  Writes the checkpoint file.
+   **/
+  void flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    flush_locked();
+  }
+
+  /**
+   *  Returns the number of completed units.
+   **/
+  std::size_t num_completed() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::size_t num = 0;
+    for (const auto& range : completed_) {
+      num += range.second - range.first;
+    }
+    return num;
+  }
+
+ private:
+  void flush_locked() {
+    last_flush_ = std::chrono::steady_clock::now();
+    if (path_.empty()) {
+      return;
+    }
+    {
+      std::ofstream file(temporary_path(path_), std::ios::trunc);
+      file << "n_cube_scan 1\n"
+           << fingerprint_ << "\n"
+           << found_ << "\n"
+           << completed_.size() << "\n";
+      for (const auto& range : completed_) {
+        file << range.first << " " << range.second << "\n";
+      }
+      if (!file.flush()) {
+        throw std::runtime_error("cannot write checkpoint " + path_.string());
+      }
+    }
+    replace_file(path_, last_flush_);
+  }
+
+  std::filesystem::path path_;
+  uint64_t fingerprint_;
+  double flush_seconds_;
+  mutable std::mutex mutex_;
+  // the completed ranges by their first unit, neither overlapping nor adjacent
+  std::map<std::size_t, std::size_t> completed_;
+  bool found_ = false;
+  std::chrono::steady_clock::time_point last_flush_;
+};
+
+/**
+ *  Calls scan(begin, end) for ranges [begin, end) of at most block units of
+ *  work that cover the num_units units of work not completed by the
+ *  checkpoint, on the participants of the default thread pool, and records
+ *  every completed range in the checkpoint. scan returns true if it found what
+ *  the scan looks for, which ends the scan.
+ *
+ *  Returns true if any call returned true, in this run or in a run the
+ *  checkpoint was resumed from, and false otherwise. As any range is either
+ *  completed before or scanned in this run, the result is the same as without
+ *  the checkpoint.
+ *
+ *  If a call of scan or writing the checkpoint throws, the scan stops and the
+ *  first exception is rethrown (see thread_pool), after the progress so far
+ *  is flushed.
+ **/
+template <typename F>
+bool scan_checkpointed(std::size_t num_units, scan_checkpoint& checkpoint,
+                       F scan, std::size_t block = checkpoint_block) {
+  if (checkpoint.found()) {
+    return true;
+  }
+  std::atomic<bool> found(false);
+  const auto worker = [&](unsigned int, std::size_t begin, std::size_t end) {
+    for (const auto& range : checkpoint.remaining(begin, end)) {
+      for (auto first = range.first; first < range.second && !found;
+           first += block) {
+        const auto last = std::min(first + block, range.second);
+        const bool found_range = scan(first, last);
+        if (found_range) {
+          found = true;
+        }
+        checkpoint.complete(first, last, found_range);
+      }
+    }
+  };
+  try {
+    default_thread_pool().parallel_for(num_units, 0, worker);
+  } catch (...) {
+    // keeps the progress so far if the checkpoint can still be written
+    try {
+      checkpoint.flush();
+    } catch (const std::runtime_error&) {
+    }
+    throw;
+  }
+  checkpoint.flush();
+  return found;
+}
+
+}  // namespace ncube
+
+#endif  // N_CUBE_CHECKPOINT_H_
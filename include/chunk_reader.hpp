@@ -0,0 +1,226 @@
+#ifndef N_CUBE_CHUNK_READER_H_
+#define N_CUBE_CHUNK_READER_H_
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "multithreaded.hpp"
+#include "set_file.hpp"
+#include "sliceable_set.hpp"
+#include "tiled_scan.hpp"
+
+namespace ncube {
+
+/* The size of a chunk read by a chunk reader by default. */
+constexpr std::size_t chunk_reader_bytes = std::size_t{1} << 26;
+
+/**
+ *  Reads the sliceable sets of a set file in chunks on a background thread.
+ *
+ *  The chunks are read into two buffers in turn: While the caller works on one
+ *  chunk, the next chunk is read into the other buffer. So reading overlaps
+ *  with the work, and only two chunks are in memory at any time, however large
+ *  the set file is.
+ **/
+template <int32_t N>
+class set_file_chunk_reader {
+ public:
+  /* A range of sliceable sets that is empty at the end of the set file. */
+  using chunk_t =
+      std::pair<const sliceable_set_t<N>*, const sliceable_set_t<N>*>;
+
+  set_file_chunk_reader(const std::filesystem::path& path,
+                        std::size_t chunk_bytes = chunk_reader_bytes)
+      : fd_(::open(path.c_str(), O_RDONLY)) {
+    if (fd_ < 0) {
+      throw std::runtime_error("cannot open set file " + path.string());
+    }
+    struct stat stat_buf;
+    if (::fstat(fd_, &stat_buf) != 0 ||
+        ::pread(fd_, &header_, sizeof(header_), 0) !=
+            static_cast<ssize_t>(sizeof(header_)) ||
+        !is_compatible_set_file<N>(
+            header_, static_cast<std::size_t>(stat_buf.st_size))) {
+      ::close(fd_);
+      throw std::runtime_error("incompatible set file " + path.string());
+    }
+#ifdef POSIX_FADV_SEQUENTIAL
+    ::posix_fadvise(fd_, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    chunk_sets_ =
+        std::max<std::size_t>(chunk_bytes / sizeof(sliceable_set_t<N>), 1);
+    for (auto& buffer : buffers_) {
+      buffer.sets.resize(std::min<std::size_t>(chunk_sets_, header_.count));
+    }
+    reader_ = std::thread(&set_file_chunk_reader::read_chunks, this);
+  }
+
+  set_file_chunk_reader(const set_file_chunk_reader&) = delete;
+  set_file_chunk_reader& operator=(const set_file_chunk_reader&) = delete;
+
+  ~set_file_chunk_reader() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    changed_.notify_all();
+    reader_.join();
+    ::close(fd_);
+  }
+
+  /**
+   *  Returns the next chunk, which stays valid until the next call. Waits
+   *  until the chunk is read.
+   **/
+  chunk_t next() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    // the previous chunk is done, so its buffer can be refilled
+    if (next_chunk_ > 0) {
+      buffers_[(next_chunk_ - 1) % 2].full = false;
+      changed_.notify_all();
+    }
+    if (next_chunk_ * chunk_sets_ >= header_.count) {
+      return chunk_t(nullptr, nullptr);
+    }
+    auto& buffer = buffers_[next_chunk_ % 2];
+    changed_.wait(lock, [&buffer] { return buffer.full; });
+    if (!error_.empty()) {
+      throw std::runtime_error(error_);
+    }
+    ++next_chunk_;
+    return chunk_t(buffer.sets.data(), buffer.sets.data() + buffer.size);
+  }
+
+  /**
+   *  Returns the number of sliceable sets in the set file.
+   **/
+  std::size_t size() const { return header_.count; }
+
+ private:
+  struct buffer_t {
+    std::vector<sliceable_set_t<N>> sets;
+    std::size_t size = 0;
+    bool full = false;
+  };
+
+  void read_chunks() {
+    for (std::size_t chunk = 0; chunk * chunk_sets_ < header_.count; ++chunk) {
+      auto& buffer = buffers_[chunk % 2];
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        changed_.wait(lock, [&] { return stop_ || !buffer.full; });
+        if (stop_) {
+          return;
+        }
+      }
+      const auto first = chunk * chunk_sets_;
+      const auto size = std::min(chunk_sets_, header_.count - first);
+      const bool read = read_records(buffer.sets.data(), first, size);
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!read) {
+        error_ = "cannot read set file";
+      }
+      buffer.size = size;
+      buffer.full = true;
+      changed_.notify_all();
+      if (!read) {
+        return;
+      }
+    }
+  }
+
+  /**
+   *  Reads size records starting at record first. Returns false if the file
+   *  ends early or reading fails and true otherwise.
+   **/
+  bool read_records(sliceable_set_t<N>* sets, std::size_t first,
+                    std::size_t size) {
+    auto* data = reinterpret_cast<char*>(sets);
+    std::size_t bytes = size * sizeof(sliceable_set_t<N>);
+    auto offset = static_cast<off_t>(header_.data_offset +
+                                     first * sizeof(sliceable_set_t<N>));
+    while (bytes > 0) {
+      const auto num_read = ::pread(fd_, data, bytes, offset);
+      if (num_read <= 0) {
+        return false;
+      }
+      data += num_read;
+      bytes -= static_cast<std::size_t>(num_read);
+      offset += num_read;
+    }
+    return true;
+  }
+
+  int fd_;
+  set_file_header_t header_;
+  std::size_t chunk_sets_ = 0;
+  buffer_t buffers_[2];
+  std::size_t next_chunk_ = 0;
+  std::mutex mutex_;
+  std::condition_variable changed_;
+  bool stop_ = false;
+  std::string error_;
+  std::thread reader_;
+};
+
+/**
+ *  Returns true if any pairwise union of the sliceable sets of a set file and
+ *  a list of sliceable sets slices all edges and false otherwise.
+ *
+ *  The set file is streamed in chunks (see set_file_chunk_reader), each of
+ *  which is scanned by pairwise_unions_slice_cube_parallel against the list,
+ *  or against its replicas on the NUMA nodes if there are any (see
+ *  replicate_per_node), while the next chunk is read. So the set file doesn't
+ *  have to fit into memory. The scan stops after the first chunk with a union
+ *  that slices all edges.
+ *
+ *  Before the first chunk is scanned, the tile sizes are tuned on a prefix of
+ *  tuning_sets sliceable sets of it (see tune_tile_sizes), unless tuning_sets
+ *  is 0.
+ *
+ *  The list is required to be sorted in lexicographic order.
+ **/
+template <int32_t N>
+bool pairwise_unions_slice_cube_streamed(
+    const std::filesystem::path& path_1,
+    const std::vector<sliceable_set_t<N>>& sets_2,
+    const std::vector<std::vector<sliceable_set_t<N>>>& replicas = {},
+    std::size_t chunk_bytes = chunk_reader_bytes,
+    std::size_t tuning_sets = tile_tuning_sets) {
+  set_file_chunk_reader<N> reader(path_1, chunk_bytes);
+  bool tuned = (tuning_sets == 0);
+  for (auto chunk = reader.next(); chunk.first != chunk.second;
+       chunk = reader.next()) {
+    if (!tuned) {
+      // the prefix is scanned again with the rest of the chunk
+      const auto num_sets =
+          static_cast<std::size_t>(chunk.second - chunk.first);
+      tune_tile_sizes<N>(chunk.first,
+                         chunk.first + std::min(tuning_sets, num_sets),
+                         sets_2.data(), sets_2.data() + sets_2.size());
+      tuned = true;
+    }
+    if (pairwise_unions_slice_cube_parallel<N>(chunk.first, chunk.second,
+                                               sets_2, replicas)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace ncube
+
+#endif  // N_CUBE_CHUNK_READER_H_
@@ -93,16 +93,12 @@ bool is_complex_degree_two(const complex_t<N>& complex) {
  **/
 template <int32_t N>
 complex_t<N> unique_complex(const complex_t<N>& complex) {
-  std::array<int32_t, N> permutation;
-  for (int32_t i = 0; i < N; ++i) {
-    permutation[i] = i;
-  }
   // Since the unique symmetric representative of a cut complex is defined as
   // the lexicographically smallest transformation, a transformation may be
   // aborted as soon as any resulting bit (starting from the leftmost bit) is 1
   // and the corresponding bit of the current minimum is 0.
   complex_t<N> min_complex(complex);
-  do {
+  for (const auto& permutation : permutations<N>) {
     for (int32_t signs = 0; signs < num_vertices(N); ++signs) {
       complex_t<N> complex_trans;
       bool is_new_min = false;
@@ -121,7 +117,7 @@ complex_t<N> unique_complex(const complex_t<N>& complex) {
         min_complex = complex_trans;
       }
     }
-  } while (std::next_permutation(permutation.begin(), permutation.end()));
+  }
   return min_complex;
 }
 
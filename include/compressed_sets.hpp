@@ -0,0 +1,290 @@
+#ifndef N_CUBE_COMPRESSED_SETS_H_
+#define N_CUBE_COMPRESSED_SETS_H_
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "bitset_comparator.hpp"
+#include "edge.hpp"
+#include "sliceable_set.hpp"
+
+namespace ncube {
+
+/* "NCUBECS" followed by a null byte. */
+constexpr char compressed_file_magic[8] = {'N', 'C', 'U', 'B',
+                                           'E', 'C', 'S', '\0'};
+
+constexpr uint32_t compressed_file_version = 1;
+
+/* The default number of sliceable sets per block. */
+constexpr uint32_t default_compressed_block_size = 128;
+
+/**
+ *  A lexicographically sorted list of sliceable sets compressed in blocks.
+ *
+ *  Within a block the first sliceable set is stored in full and every other
+ *  sliceable set as the number of leading bytes it shares with its predecessor
+ *  followed by its remaining bytes (front coding). A block index stores the
+ *  offset of every block, so blocks can be decompressed independently.
+ **/
+template <int32_t N>
+class compressed_sets {
+ public:
+  compressed_sets() = default;
+
+  /**
+   *  Compresses sliceable sets sorted in lexicographic order.
+   **/
+  explicit compressed_sets(const std::vector<sliceable_set_t<N>>& sets,
+                           uint32_t block_size = default_compressed_block_size)
+      : block_size_(block_size), size_(sets.size()) {
+    constexpr std::size_t image_size = sizeof(sliceable_set_image_t<N>);
+    sliceable_set_image_t<N> prev = {};
+    offsets_.clear();
+    for (std::size_t i = 0; i < sets.size(); ++i) {
+      const auto image = sliceable_set_to_image<N>(sets[i]);
+      std::size_t shared = 0;
+      if (i % block_size_ == 0) {
+        offsets_.push_back(data_.size());
+      } else {
+        while (shared < image_size && image[shared] == prev[shared]) {
+          ++shared;
+        }
+        data_.push_back(static_cast<unsigned char>(shared));
+      }
+      data_.insert(data_.end(), image.begin() + shared, image.end());
+      prev = image;
+    }
+    offsets_.push_back(data_.size());
+  }
+
+  std::size_t size() const { return size_; }
+
+  std::size_t num_blocks() const { return offsets_.size() - 1; }
+
+  /**
+   *  Returns the number of bytes of the compressed sliceable sets.
+   **/
+  std::size_t compressed_bytes() const {
+    return data_.size() + offsets_.size() * sizeof(uint64_t);
+  }
+
+  /**
+   *  Decompresses the i-th block into a buffer.
+   **/
+  void decode_block(std::size_t i,
+                    std::vector<sliceable_set_t<N>>& buffer) const {
+    constexpr std::size_t image_size = sizeof(sliceable_set_image_t<N>);
+    buffer.clear();
+    const auto begin = static_cast<std::ptrdiff_t>(offsets_[i]);
+    const auto end = static_cast<std::ptrdiff_t>(offsets_[i + 1]);
+    auto it = data_.begin() + begin;
+    sliceable_set_image_t<N> image;
+    std::copy(it, it + image_size, image.begin());
+    it += image_size;
+    buffer.push_back(image_to_sliceable_set<N>(image));
+    while (it != data_.begin() + end) {
+      const std::size_t shared = *it++;
+      const auto suffix = static_cast<std::ptrdiff_t>(image_size - shared);
+      std::copy(it, it + suffix, image.begin() + shared);
+      it += suffix;
+      buffer.push_back(image_to_sliceable_set<N>(image));
+    }
+  }
+
+  /**
+   *  Returns all sliceable sets decompressed.
+   **/
+  std::vector<sliceable_set_t<N>> to_vector() const {
+    std::vector<sliceable_set_t<N>> sets;
+    sets.reserve(size_);
+    std::vector<sliceable_set_t<N>> buffer;
+    for (std::size_t i = 0; i < num_blocks(); ++i) {
+      decode_block(i, buffer);
+      sets.insert(sets.end(), buffer.begin(), buffer.end());
+    }
+    return sets;
+  }
+
+  /**
+   *  Writes the compressed sliceable sets to a file at the given path.
+   **/
+  void write_to_file(const std::filesystem::path& path) const {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+      throw std::runtime_error("cannot open compressed file " + path.string());
+    }
+    const uint32_t header[4] = {
+        compressed_file_version, static_cast<uint32_t>(N),
+        static_cast<uint32_t>(sizeof(sliceable_set_t<N>)), block_size_};
+    const uint64_t sizes[3] = {size_, offsets_.size(), data_.size()};
+    file.write(compressed_file_magic, sizeof(compressed_file_magic));
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(sizes), sizeof(sizes));
+    file.write(reinterpret_cast<const char*>(offsets_.data()),
+               static_cast<std::streamsize>(offsets_.size() * 8));
+    file.write(reinterpret_cast<const char*>(data_.data()),
+               static_cast<std::streamsize>(data_.size()));
+    file.close();
+    if (!file) {
+      throw std::runtime_error("cannot write compressed file " +
+                               path.string());
+    }
+  }
+
+  /**
+   *  Returns the compressed sliceable sets stored in a file at the given path.
+   *
+   *  Naturally, this function should be called on a file created by
+   *  write_to_file.
+   **/
+  static compressed_sets read_from_file(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+      throw std::runtime_error("cannot open compressed file " + path.string());
+    }
+    char magic[sizeof(compressed_file_magic)];
+    uint32_t header[4];
+    uint64_t sizes[3];
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(header), sizeof(header));
+    file.read(reinterpret_cast<char*>(sizes), sizeof(sizes));
+    if (!file || std::memcmp(magic, compressed_file_magic, sizeof(magic)) ||
+        header[0] != compressed_file_version ||
+        header[1] != static_cast<uint32_t>(N) ||
+        header[2] != sizeof(sliceable_set_t<N>)) {
+      throw std::runtime_error("incompatible compressed file " +
+                               path.string());
+    }
+    // check the sizes against the file before allocating anything
+    const uint64_t header_bytes =
+        sizeof(magic) + sizeof(header) + sizeof(sizes);
+    const uint64_t file_bytes = std::filesystem::file_size(path);
+    const uint64_t num_blocks =
+        header[3] == 0 ? 0 : (sizes[0] + header[3] - 1) / header[3];
+    if (header[3] == 0 || sizes[1] != num_blocks + 1 ||
+        sizes[1] > (file_bytes - header_bytes) / 8 ||
+        sizes[2] != file_bytes - header_bytes - sizes[1] * 8) {
+      throw std::runtime_error("corrupt compressed file " + path.string());
+    }
+    compressed_sets sets;
+    sets.block_size_ = header[3];
+    sets.size_ = sizes[0];
+    sets.offsets_.resize(sizes[1]);
+    sets.data_.resize(sizes[2]);
+    file.read(reinterpret_cast<char*>(sets.offsets_.data()),
+              static_cast<std::streamsize>(sizes[1] * 8));
+    file.read(reinterpret_cast<char*>(sets.data_.data()),
+              static_cast<std::streamsize>(sizes[2]));
+    if (!file) {
+      throw std::runtime_error("cannot read compressed file " + path.string());
+    }
+    if (!sets.is_well_formed()) {
+      throw std::runtime_error("corrupt compressed file " + path.string());
+    }
+    return sets;
+  }
+
+ private:
+  /**
+   *  Returns true if the block index and the blocks describe exactly size_
+   *  sliceable sets in blocks of block_size_, so decode_block stays within
+   *  data_, and false otherwise.
+   **/
+  bool is_well_formed() const {
+    constexpr std::size_t image_size = sizeof(sliceable_set_image_t<N>);
+    if (offsets_.front() != 0 || offsets_.back() != data_.size()) {
+      return false;
+    }
+    std::size_t num_sets = 0;
+    for (std::size_t i = 0; i < num_blocks(); ++i) {
+      if (offsets_[i] > offsets_[i + 1] ||
+          offsets_[i + 1] - offsets_[i] < image_size) {
+        return false;
+      }
+      // the first sliceable set is stored in full
+      std::size_t pos = offsets_[i] + image_size;
+      std::size_t num_block_sets = 1;
+      while (pos < offsets_[i + 1]) {
+        const std::size_t shared = data_[pos];
+        if (shared > image_size ||
+            offsets_[i + 1] - pos - 1 < image_size - shared) {
+          return false;
+        }
+        pos += 1 + image_size - shared;
+        ++num_block_sets;
+      }
+      const std::size_t expected_block_sets =
+          std::min<std::size_t>(block_size_, size_ - num_sets);
+      if (num_block_sets != expected_block_sets) {
+        return false;
+      }
+      num_sets += num_block_sets;
+    }
+    return num_sets == size_;
+  }
+
+  uint32_t block_size_ = default_compressed_block_size;
+  std::size_t size_ = 0;
+  std::vector<uint64_t> offsets_ = {0};
+  std::vector<unsigned char> data_;
+};
+
+/**
+ *  Returns true if any pairwise union of a list of sliceable sets and a list of
+ *  compressed sliceable sets slices all edges and false otherwise.
+ *
+ *  Every block of the second list is decompressed once and scanned against all
+ *  sliceable sets of the first list that may complete a sliceable set of the
+ *  block. The blocks are visited from the last to the first, so the scan stops
+ *  at the first block without enough leading 1-bits for any set of the first
+ *  list.
+ **/
+template <int32_t N>
+bool pairwise_unions_slice_cube(const std::vector<sliceable_set_t<N>>& sets_1,
+                                const compressed_sets<N>& sets_2) {
+  // sets_1 sorted by leading zeros
+  std::vector<std::pair<int32_t, sliceable_set_t<N>>> sorted_sets_1;
+  sorted_sets_1.reserve(sets_1.size());
+  for (const auto& set_1 : sets_1) {
+    sorted_sets_1.emplace_back(get_leading_zeros<N>(set_1), set_1);
+  }
+  const auto by_leading_zeros = [](const auto& x, const auto& y) {
+    return x.first < y.first;
+  };
+  std::sort(sorted_sets_1.begin(), sorted_sets_1.end(), by_leading_zeros);
+  std::vector<sliceable_set_t<N>> block;
+  for (std::size_t b = sets_2.num_blocks(); b-- > 0;) {
+    sets_2.decode_block(b, block);
+    const int32_t max_leading_ones = get_leading_ones<N>(block.back());
+    if (sorted_sets_1.empty() || max_leading_ones < sorted_sets_1[0].first) {
+      break;
+    }
+    for (const auto& [leading_zeros, set_1] : sorted_sets_1) {
+      if (max_leading_ones < leading_zeros) {
+        break;
+      }
+      for (auto set_2 = block.rbegin(); set_2 != block.rend(); ++set_2) {
+        const int32_t leading_ones = get_leading_ones<N>(*set_2);
+        if (leading_ones < leading_zeros) {
+          break;
+        }
+        if ((set_1 | *set_2).all()) {
+          return true;
+        }
+      }
+    }
+  }
+  return false;
+}
+
+}  // namespace ncube
+
+#endif  // N_CUBE_COMPRESSED_SETS_H_
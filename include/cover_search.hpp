@@ -0,0 +1,205 @@
+#ifndef N_CUBE_COVER_SEARCH_H_
+#define N_CUBE_COVER_SEARCH_H_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <numeric>
+#include <vector>
+
+#include "edge.hpp"
+#include "facet.hpp"
+#include "sliceable_set.hpp"
+#include "thread_pool.hpp"
+
+namespace ncube {
+
+/**
+ *  Decides by depth-first search if k sliceable sets of a symmetric family
+ *  slice the n-cube, without computing any unions of sliceable sets.
+ *
+ *  The family is given by unique symmetric representatives, which are expanded
+ *  orbit by orbit. A search fixes the first sliceable set to the
+ *  representative of an orbit and only picks the other sliceable sets from the
+ *  same or later orbits, since every combination can be transformed to one
+ *  that contains the representative of its first orbit. Every node branches on
+ *  the unsliced edge that is sliced by the fewest remaining sliceable sets. A
+ *  node is pruned if that edge is not sliced by any remaining sliceable set or
+ *  if the remaining sliceable sets can't slice enough unsliced edges of the
+ *  n-cube or of any of its facets.
+ *
+ *  The searches of different representatives run in parallel on the default
+ *  thread pool, which balances their very different sizes by work stealing.
+ *  Every search needs O(k * |mss|) memory for the candidates of its path.
+ **/
+template <int32_t N>
+class cover_search {
+ public:
+  cover_search(const std::vector<sliceable_set_t<N>>& usr,
+               const edge_lexicon_t<N>& edges)
+      : usr_(usr) {
+    orbit_begin_.reserve(usr.size() + 1);
+    std::vector<sliceable_set_t<N>> orbit;
+    for (const auto& ss : usr) {
+      orbit_begin_.push_back(static_cast<uint32_t>(mss_.size()));
+      orbit.clear();
+      const auto add = [&orbit](const sliceable_set_t<N>& ss_trans) {
+        orbit.push_back(ss_trans);
+      };
+      for_each_transformation<N>(ss, edges, add);
+      std::sort(orbit.begin(), orbit.end());
+      orbit.erase(std::unique(orbit.begin(), orbit.end()), orbit.end());
+      mss_.insert(mss_.end(), orbit.begin(), orbit.end());
+    }
+    orbit_begin_.push_back(static_cast<uint32_t>(mss_.size()));
+    const auto facets = compute_facet_edges<N>(edges);
+    for (int32_t f = 0; f < num_facets(N); ++f) {
+      for (const auto e : facets[f]) {
+        facet_masks_[f][e] = true;
+      }
+    }
+  }
+
+  /**
+   *  Returns the symmetry expansions of the unique symmetric representatives,
+   *  grouped by orbit.
+   **/
+  const std::vector<sliceable_set_t<N>>& mss() const { return mss_; }
+
+  /**
+   *  Returns true if a combination of k sliceable sets slices the n-cube and
+   *  false otherwise. The combination found last is available as witness.
+   **/
+  bool slices_cube(int32_t k) {
+    witness_.clear();
+    if (k <= 0 || usr_.empty()) {
+      return false;
+    }
+    std::vector<uint32_t> indices(mss_.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    std::atomic<bool> found(false);
+    std::mutex witness_mutex;
+    const auto worker = [&](unsigned int, std::size_t begin, std::size_t end) {
+      search_state state(k, found);
+      for (auto i = begin; i < end && !found; ++i) {
+        const auto* candidates_begin = indices.data() + orbit_begin_[i];
+        const auto* candidates_end = indices.data() + indices.size();
+        state.path.assign(1, usr_[i]);
+        if (search(state, usr_[i], k - 1, candidates_begin, candidates_end)) {
+          found = true;
+          std::lock_guard<std::mutex> lock(witness_mutex);
+          witness_ = state.path;
+        }
+      }
+    };
+    default_thread_pool().parallel_for(usr_.size(), 1, worker);
+    return found;
+  }
+
+  /**
+   *  Returns the sliceable sets of the combination found by the last call of
+   *  slices_cube, or an empty list if there wasn't any.
+   **/
+  const std::vector<sliceable_set_t<N>>& witness() const { return witness_; }
+
+ private:
+  struct search_state {
+    search_state(int32_t k, const std::atomic<bool>& found_)
+        : candidates(static_cast<std::size_t>(k)), found(found_) {}
+
+    // candidates[r] are the candidates of a node with r sets left to pick
+    std::vector<std::vector<uint32_t>> candidates;
+    std::vector<sliceable_set_t<N>> path;
+    const std::atomic<bool>& found;
+  };
+
+  /**
+   *  Returns true if at most num_left sliceable sets among the candidates
+   *  slice all edges that aren't sliced yet and false otherwise. Appends the
+   *  picked sliceable sets to the path of the state.
+   **/
+  bool search(search_state& state, const sliceable_set_t<N>& sliced,
+              int32_t num_left, const uint32_t* candidates_begin,
+              const uint32_t* candidates_end) const {
+    if (sliced.all()) {
+      return true;
+    }
+    if (num_left == 0 || state.found) {
+      return false;
+    }
+    // keep the candidates that slice unsliced edges and count the candidates
+    // of every unsliced edge
+    auto& candidates = state.candidates[static_cast<std::size_t>(num_left)];
+    candidates.clear();
+    std::array<uint32_t, num_edges(N)> counts = {};
+    std::size_t max_gain = 0;
+    std::array<std::size_t, num_facets(N)> max_facet_gains = {};
+    for (auto it = candidates_begin; it != candidates_end; ++it) {
+      const auto gain = mss_[*it] & ~sliced;
+      if (gain.none()) {
+        continue;
+      }
+      candidates.push_back(*it);
+      max_gain = std::max(max_gain, gain.count());
+      for (int32_t f = 0; f < num_facets(N); ++f) {
+        max_facet_gains[f] =
+            std::max(max_facet_gains[f], (gain & facet_masks_[f]).count());
+      }
+      for (int32_t e = 0; e < num_edges(N); ++e) {
+        counts[e] += gain[e];
+      }
+    }
+    const auto num_unsliced = num_edges(N) - sliced.count();
+    if (num_unsliced > static_cast<std::size_t>(num_left) * max_gain) {
+      return false;
+    }
+    for (int32_t f = 0; f < num_facets(N); ++f) {
+      const auto num_unsliced_f = (facet_masks_[f] & ~sliced).count();
+      if (num_unsliced_f >
+          static_cast<std::size_t>(num_left) * max_facet_gains[f]) {
+        return false;
+      }
+    }
+    int32_t branch_edge = -1;
+    for (int32_t e = 0; e < num_edges(N); ++e) {
+      if (!sliced[e] && (branch_edge < 0 || counts[e] < counts[branch_edge])) {
+        branch_edge = e;
+      }
+    }
+    if (counts[branch_edge] == 0) {
+      return false;
+    }
+    // A candidate that has been tried for the branch edge is not picked by
+    // the later branches, as every combination with it has been searched.
+    auto children_end = candidates.end();
+    for (auto it = candidates.begin(); it != children_end;) {
+      const auto& ss = mss_[*it];
+      if (!ss[branch_edge]) {
+        ++it;
+        continue;
+      }
+      state.path.push_back(ss);
+      if (search(state, sliced | ss, num_left - 1, candidates.data(),
+                 candidates.data() + (children_end - candidates.begin()))) {
+        return true;
+      }
+      state.path.pop_back();
+      --children_end;
+      std::iter_swap(it, children_end);
+    }
+    return false;
+  }
+
+  std::vector<sliceable_set_t<N>> usr_;
+  std::vector<sliceable_set_t<N>> mss_;
+  // the expansions of usr_[i] are mss_[orbit_begin_[i]:orbit_begin_[i + 1]]
+  std::vector<uint32_t> orbit_begin_;
+  std::vector<sliceable_set_t<N>> witness_;
+  std::array<sliceable_set_t<N>, num_facets(N)> facet_masks_;
+};
+
+}  // namespace ncube
+
+#endif  // N_CUBE_COVER_SEARCH_H_
@@ -1,7 +1,6 @@
 #ifndef N_CUBE_EDGE_H_
 #define N_CUBE_EDGE_H_
 
-#include <algorithm>
 #include <array>
 #include <cstdint>
 #include <utility>
@@ -34,33 +33,141 @@ edge_t transform_edge(edge_t e, const std::array<int32_t, N>& permutation,
   return (u < v) ? edge_t(u, v) : edge_t(v, u);
 }
 
+/**
+ *  Returns all edges in lexicographic order.
+ *
+ *  The edges are generated in order: the edges of a vertex u to its larger
+ *  neighbours u | 2^i come in ascending order of i.
+ **/
+template <int32_t N>
+constexpr edge_lexicon_t<N> compute_edge_lexicon() {
+  edge_lexicon_t<N> edges{};
+  int32_t e = 0;
+  for (vertex_t u = 0; u < num_vertices(N); ++u) {
+    for (int32_t i = 0; i < N; ++i) {
+      const vertex_t v = get_neighbour(u, i);
+      if (u < v) {
+        edges[e].first = u;
+        edges[e].second = v;
+        ++e;
+      }
+    }
+  }
+  return edges;
+}
+
+/* All edges in lexicographic order, computed at compile time. */
+template <int32_t N>
+inline constexpr edge_lexicon_t<N> edge_lexicon = compute_edge_lexicon<N>();
+
+/**
+ *  Returns the coordinate in which the two vertices of an edge differ.
+ **/
+constexpr int32_t get_direction(const edge_t& e) {
+  int32_t i = 0;
+  while (get_neighbour(e.first, i) != e.second) {
+    ++i;
+  }
+  return i;
+}
+
+/* For every edge the coordinate in which its vertices differ. */
+template <int32_t N>
+using edge_directions_t = std::array<int32_t, num_edges(N)>;
+
+template <int32_t N>
+constexpr edge_directions_t<N> compute_edge_directions() {
+  edge_directions_t<N> directions{};
+  for (int32_t e = 0; e < num_edges(N); ++e) {
+    directions[e] = get_direction(edge_lexicon<N>[e]);
+  }
+  return directions;
+}
+
+/* The edge directions, computed at compile time. */
+template <int32_t N>
+inline constexpr edge_directions_t<N> edge_directions =
+    compute_edge_directions<N>();
+
+/* The enumeration of the edge between vertex v and its i-th neighbour is
+ * stored at index v * n + i. */
+template <int32_t N>
+using edge_of_vertex_t = std::array<int32_t, num_vertices(N) * N>;
+
+template <int32_t N>
+constexpr edge_of_vertex_t<N> compute_edge_of_vertex() {
+  edge_of_vertex_t<N> edge_of_vertex{};
+  for (int32_t e = 0; e < num_edges(N); ++e) {
+    const auto& edge = edge_lexicon<N>[e];
+    const auto i = edge_directions<N>[e];
+    edge_of_vertex[edge.first * N + i] = e;
+    edge_of_vertex[edge.second * N + i] = e;
+  }
+  return edge_of_vertex;
+}
+
+/* The edges of every vertex, computed at compile time. */
+template <int32_t N>
+inline constexpr edge_of_vertex_t<N> edge_of_vertex =
+    compute_edge_of_vertex<N>();
+
 /**
  *  Returns the enumeration of an edge over the lexicographic order of all
- *  edges.
+ *  edges, which the given edges are required to be (see compute_edges).
  **/
 template <int32_t N>
-int32_t edge_to_int(const edge_t& e, const edge_lexicon_t<N>& edges) {
-  const auto e_it = std::lower_bound(edges.begin(), edges.end(), e);
-  return static_cast<int32_t>(e_it - edges.begin());
+constexpr int32_t edge_to_int(const edge_t& e,
+                              const edge_lexicon_t<N>& /*edges*/) {
+  return edge_of_vertex<N>[e.first * N + get_direction(e)];
 }
 
 /**
  *  Returns all edges in lexicographic order.
  **/
 template <int32_t N>
-edge_lexicon_t<N> compute_edges() {
-  edge_lexicon_t<N> edges;
-  auto it = edges.begin();
-  for (vertex_t v = 0; v < num_vertices(N); ++v) {
-    for (int32_t i = 0; i < N; ++i) {
-      const vertex_t u = get_neighbour(v, i);
-      if (u < v) {
-        *it++ = edge_t(u, v);
-      }
-    }
+const edge_lexicon_t<N>& compute_edges() {
+  return edge_lexicon<N>;
+}
+
+/* The edges transformed by a permutation of the coordinates (see
+ * permute_edges). */
+template <int32_t N>
+struct permuted_edges_t {
+  std::array<vertex_t, num_edges(N)> vertices;
+  std::array<int32_t, num_edges(N)> directions;
+};
+
+/**
+ *  Returns the first vertex and the direction of every edge after permuting
+ *  its coordinates.
+ *
+ *  Since permuting coordinates commutes with flipping signs, the symmetric
+ *  transformation by a permutation and signs maps edge e to the edge between
+ *  vertices[e] ^ transform_vertex(signs, permutation, 0) and its
+ *  directions[e]-th neighbour (see transform_edge_int). So all transformations
+ *  by the same permutation share this table.
+ **/
+template <int32_t N>
+permuted_edges_t<N> permute_edges(const std::array<int32_t, N>& permutation,
+                                  const edge_lexicon_t<N>& edges) {
+  permuted_edges_t<N> permuted;
+  for (int32_t e = 0; e < num_edges(N); ++e) {
+    permuted.vertices[e] = transform_vertex<N>(edges[e].first, permutation, 0);
+    permuted.directions[e] = permutation[edge_directions<N>[e]];
   }
-  std::sort(edges.begin(), edges.end());
-  return edges;
+  return permuted;
+}
+
+/**
+ *  Returns the enumeration of the symmetric transformation of an edge by the
+ *  permutation of permuted edges and the signs whose coordinates are permuted
+ *  to permuted_signs.
+ **/
+template <int32_t N>
+int32_t transform_edge_int(const permuted_edges_t<N>& permuted, int32_t e,
+                           vertex_t permuted_signs) {
+  const vertex_t v = permuted.vertices[e] ^ permuted_signs;
+  return edge_of_vertex<N>[v * N + permuted.directions[e]];
 }
 
 }  // namespace ncube
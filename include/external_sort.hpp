@@ -0,0 +1,330 @@
+#ifndef N_CUBE_EXTERNAL_SORT_H_
+#define N_CUBE_EXTERNAL_SORT_H_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ncube {
+
+/* A fixed size record of bytes. Records are ordered by comparing their bytes
+ * as unsigned chars from the first to the last byte.
+ */
+template <std::size_t R>
+using record_t = std::array<char, R>;
+
+/* 1 GiB */
+constexpr std::size_t default_sort_buffer_bytes = std::size_t{1} << 30;
+
+/* The most run files merged at once, each with a read buffer of 1 MiB. */
+constexpr std::size_t max_merge_fan_in = 64;
+
+/**
+ *  Returns true if the first record is smaller than the second record and false
+ *  otherwise.
+ **/
+template <std::size_t R>
+bool record_less(const record_t<R>& x, const record_t<R>& y) {
+  return std::memcmp(x.data(), y.data(), R) < 0;
+}
+
+/**
+ *  Returns a new path for a run file in the given directory.
+ **/
+std::filesystem::path next_run_path(const std::filesystem::path& dir) {
+  static std::atomic<uint64_t> run_counter(0);
+  const auto run_id = run_counter.fetch_add(1);
+  return dir / ("run_" + std::to_string(run_id) + ".bin");
+}
+
+/**
+ *  Sorts fixed size records that don't fit into memory.
+ *
+ *  Records are collected in a buffer of bounded size. Whenever the buffer is
+ *  full, it is sorted and written to a run file in a temporary directory. The
+ *  run files are merged by merge_runs and deleted with the sorter.
+ *
+ *  If unique is true, duplicate records are discarded from a full buffer
+ *  first, and the buffer is only written if that doesn't free half of it.
+ **/
+template <std::size_t R>
+class external_sorter {
+ public:
+  external_sorter(const std::filesystem::path& tmp_dir,
+                  std::size_t buffer_bytes, bool unique = false)
+      : tmp_dir_(tmp_dir),
+        buffer_capacity_(std::max<std::size_t>(buffer_bytes / R, 2)),
+        unique_(unique) {
+    std::filesystem::create_directories(tmp_dir_);
+    buffer_.reserve(buffer_capacity_);
+  }
+
+  external_sorter(const external_sorter&) = delete;
+  external_sorter& operator=(const external_sorter&) = delete;
+
+  external_sorter(external_sorter&& other) noexcept
+      : tmp_dir_(std::move(other.tmp_dir_)),
+        buffer_capacity_(other.buffer_capacity_),
+        unique_(other.unique_),
+        buffer_(std::move(other.buffer_)),
+        runs_(std::move(other.runs_)) {
+    other.runs_.clear();
+  }
+
+  ~external_sorter() {
+    for (const auto& run : runs_) {
+      std::error_code ec;
+      std::filesystem::remove(run, ec);
+    }
+  }
+
+  void push(const record_t<R>& record) {
+    buffer_.push_back(record);
+    if (buffer_.size() == buffer_capacity_) {
+      sort_buffer();
+      if (!unique_ || buffer_.size() >= buffer_capacity_ / 2) {
+        write_run();
+      }
+    }
+  }
+
+  /**
+   *  Writes the remaining records to a run file and returns all run files.
+   **/
+  const std::vector<std::filesystem::path>& finish() {
+    if (!buffer_.empty()) {
+      sort_buffer();
+      write_run();
+    }
+    return runs_;
+  }
+
+ private:
+  void sort_buffer() {
+    std::sort(buffer_.begin(), buffer_.end(), record_less<R>);
+    if (unique_) {
+      buffer_.erase(std::unique(buffer_.begin(), buffer_.end()),
+                    buffer_.end());
+    }
+  }
+
+  /* Requires the buffer to be sorted. Throws if the run can't be written. */
+  void write_run() {
+    const auto path = next_run_path(tmp_dir_);
+    runs_.push_back(path);
+    std::ofstream file(path, std::ios::binary);
+    file.write(buffer_.front().data(),
+               static_cast<std::streamsize>(buffer_.size() * R));
+    file.close();
+    if (!file) {
+      throw std::runtime_error("cannot write run file " + path.string());
+    }
+    buffer_.clear();
+  }
+
+  std::filesystem::path tmp_dir_;
+  std::size_t buffer_capacity_;
+  bool unique_;
+  std::vector<record_t<R>> buffer_;
+  std::vector<std::filesystem::path> runs_;
+};
+
+/**
+ *  Reads the records of a run file sequentially through a buffer. Throws if
+ *  the run file can't be opened or read, or ends within a record.
+ **/
+template <std::size_t R>
+class run_reader {
+ public:
+  run_reader(const std::filesystem::path& path, std::size_t buffer_records)
+      : path_(path), file_(path, std::ios::binary), buffer_(buffer_records) {
+    if (!file_) {
+      throw std::runtime_error("cannot open run file " + path_.string());
+    }
+    fill();
+  }
+
+  bool empty() const { return pos_ == end_; }
+
+  const record_t<R>& front() const { return buffer_[pos_]; }
+
+  void pop() {
+    if (++pos_ == end_) {
+      fill();
+    }
+  }
+
+ private:
+  void fill() {
+    pos_ = 0;
+    end_ = 0;
+    if (file_.eof()) {
+      return;
+    }
+    file_.read(buffer_.front().data(),
+               static_cast<std::streamsize>(buffer_.size() * R));
+    const auto num_bytes = static_cast<std::size_t>(file_.gcount());
+    // a short read is only fine at the end of the file
+    if (file_.bad() || (!file_ && !file_.eof()) || num_bytes % R != 0) {
+      throw std::runtime_error("cannot read run file " + path_.string());
+    }
+    end_ = num_bytes / R;
+  }
+
+  std::filesystem::path path_;
+  std::ifstream file_;
+  std::vector<record_t<R>> buffer_;
+  std::size_t pos_ = 0;
+  std::size_t end_ = 0;
+};
+
+/**
+ *  Merges at most max_merge_fan_in sorted run files and calls f(record) for
+ *  every record in order. If unique is true, equal records are passed to f
+ *  only once.
+ **/
+template <std::size_t R, typename F>
+void merge_runs_once(const std::vector<std::filesystem::path>& runs,
+                     bool unique, F f) {
+  // 1 MiB read buffer per run
+  const std::size_t buffer_records = std::max<std::size_t>((1 << 20) / R, 1);
+  std::vector<run_reader<R>> readers;
+  readers.reserve(runs.size());
+  for (const auto& run : runs) {
+    readers.emplace_back(run, buffer_records);
+  }
+  const auto greater = [&readers](std::size_t i, std::size_t j) {
+    return record_less<R>(readers[j].front(), readers[i].front());
+  };
+  std::priority_queue<std::size_t, std::vector<std::size_t>, decltype(greater)>
+      heap(greater);
+  for (std::size_t i = 0; i < readers.size(); ++i) {
+    if (!readers[i].empty()) {
+      heap.push(i);
+    }
+  }
+  record_t<R> prev;
+  bool has_prev = false;
+  while (!heap.empty()) {
+    const auto i = heap.top();
+    heap.pop();
+    const auto& record = readers[i].front();
+    if (!unique || !has_prev || record != prev) {
+      f(record);
+      prev = record;
+      has_prev = true;
+    }
+    readers[i].pop();
+    if (!readers[i].empty()) {
+      heap.push(i);
+    }
+  }
+}
+
+/**
+ *  Writes the records of a merge of sorted run files to a file at the given
+ *  path. Throws if the file can't be written.
+ **/
+template <std::size_t R>
+void merge_runs_once_to_file(const std::vector<std::filesystem::path>& runs,
+                             bool unique, const std::filesystem::path& path) {
+  std::ofstream file(path, std::ios::binary);
+  if (!file) {
+    throw std::runtime_error("cannot open merged file " + path.string());
+  }
+  const auto write = [&file](const record_t<R>& record) {
+    file.write(record.data(), R);
+  };
+  merge_runs_once<R>(runs, unique, write);
+  file.close();
+  if (!file) {
+    throw std::runtime_error("cannot write merged file " + path.string());
+  }
+}
+
+/**
+ *  Merges sorted run files and calls f(record) for every record in order. If
+ *  unique is true, equal records are passed to f only once.
+ *
+ *  At most max_merge_fan_in run files are open at a time, so the memory and
+ *  the file descriptors used are bounded however many runs there are. Larger
+ *  numbers of runs are merged in passes into intermediate run files next to
+ *  the first run, which are deleted when they are merged. Throws if any run
+ *  can't be read or written.
+ **/
+template <std::size_t R, typename F>
+void merge_runs(const std::vector<std::filesystem::path>& runs, bool unique,
+                F f) {
+  if (runs.size() <= max_merge_fan_in) {
+    merge_runs_once<R>(runs, unique, f);
+    return;
+  }
+  // the intermediate runs of the current pass, deleted on any exit
+  struct intermediate_runs_t {
+    std::vector<std::filesystem::path> paths;
+    ~intermediate_runs_t() { remove(); }
+    void remove() {
+      for (const auto& path : paths) {
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+      }
+      paths.clear();
+    }
+  };
+  const auto dir = runs.front().parent_path();
+  auto pass_runs = runs;
+  intermediate_runs_t inputs;
+  while (pass_runs.size() > max_merge_fan_in) {
+    intermediate_runs_t outputs;
+    for (std::size_t first = 0; first < pass_runs.size();
+         first += max_merge_fan_in) {
+      const auto last = std::min(first + max_merge_fan_in, pass_runs.size());
+      const std::vector<std::filesystem::path> group(
+          pass_runs.begin() + static_cast<std::ptrdiff_t>(first),
+          pass_runs.begin() + static_cast<std::ptrdiff_t>(last));
+      outputs.paths.push_back(next_run_path(dir));
+      merge_runs_once_to_file<R>(group, unique, outputs.paths.back());
+    }
+    inputs.remove();
+    std::swap(inputs.paths, outputs.paths);
+    pass_runs = inputs.paths;
+  }
+  merge_runs_once<R>(pass_runs, unique, f);
+}
+
+/**
+ *  Merges sorted run files into a single file of records at the given path. If
+ *  unique is true, duplicate records are discarded. Throws if the file can't be
+ *  written.
+ **/
+template <std::size_t R>
+void merge_runs_to_file(const std::vector<std::filesystem::path>& runs,
+                        bool unique, const std::filesystem::path& path) {
+  std::ofstream file(path, std::ios::binary);
+  if (!file) {
+    throw std::runtime_error("cannot open merged file " + path.string());
+  }
+  const auto write = [&file](const record_t<R>& record) {
+    file.write(record.data(), R);
+  };
+  merge_runs<R>(runs, unique, write);
+  file.close();
+  if (!file) {
+    throw std::runtime_error("cannot write merged file " + path.string());
+  }
+}
+
+}  // namespace ncube
+
+#endif  // N_CUBE_EXTERNAL_SORT_H_
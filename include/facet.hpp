@@ -0,0 +1,210 @@
+#ifndef N_CUBE_FACET_H_
+#define N_CUBE_FACET_H_
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "bitset_comparator.hpp"
+#include "edge.hpp"
+#include "sliceable_set.hpp"
+#include "vertex.hpp"
+
+namespace ncube {
+
+/* The n-cube has a facet for each coordinate and each of its two values. */
+constexpr int32_t num_facets(int32_t n) { return 2 * n; }
+
+/* For each facet the edges of the n-cube in the facet, enumerated over the
+ * lexicographic order of the edges of the (n - 1)-cube. Facet 2 * i + b
+ * consists of the vertices whose i-th coordinate is b.
+ */
+template <int32_t N>
+using facet_lexicon_t =
+    std::array<std::array<int32_t, num_edges(N - 1)>, num_facets(N)>;
+
+/**
+ *  Returns the vertex of the n-cube in facet 2 * i + b that corresponds to a
+ *  vertex of the (n - 1)-cube.
+ **/
+vertex_t lift_vertex(vertex_t v, int32_t i, int32_t b) {
+  const vertex_t low = v & ((1 << i) - 1);
+  return ((v >> i) << (i + 1)) | (b << i) | low;
+}
+
+/**
+ *  Returns the edges of all facets.
+ **/
+template <int32_t N>
+facet_lexicon_t<N> compute_facet_edges(const edge_lexicon_t<N>& edges) {
+  static_assert(N >= 2, "the facets of the n-cube require n >= 2");
+  const auto& facet_edges = compute_edges<N - 1>();
+  facet_lexicon_t<N> facets;
+  for (int32_t f = 0; f < num_facets(N); ++f) {
+    const int32_t i = f / 2;
+    const int32_t b = f % 2;
+    for (int32_t e = 0; e < num_edges(N - 1); ++e) {
+      const edge_t lifted(lift_vertex(facet_edges[e].first, i, b),
+                          lift_vertex(facet_edges[e].second, i, b));
+      facets[f][e] = edge_to_int<N>(lifted, edges);
+    }
+  }
+  return facets;
+}
+
+/**
+ *  Returns the restriction of a sliceable set of the n-cube to a facet, which
+ *  is a sliceable set of the (n - 1)-cube.
+ **/
+template <int32_t N>
+sliceable_set_t<N - 1> project_to_facet(
+    const sliceable_set_t<N>& ss,
+    const std::array<int32_t, num_edges(N - 1)>& facet_edges) {
+  sliceable_set_t<N - 1> projection;
+  for (int32_t e = 0; e < num_edges(N - 1); ++e) {
+    projection[e] = ss[facet_edges[e]];
+  }
+  return projection;
+}
+
+/**
+ *  The restrictions of a list of sliceable sets to all facets.
+ *
+ *  Sliceable sets only slice the n-cube if their restrictions slice every
+ *  facet. For each facet, the distinct restrictions of the list are numbered
+ *  and every sliceable set stores the numbers of its restrictions. A sliceable
+ *  set that is scanned against the list gets a compatibility table with one
+ *  entry per facet and restriction, telling if the union of the restrictions
+ *  slices the facet. An entry is computed when it is first needed, so that a
+ *  pair is rejected by a lookup per facet instead of a union of full width
+ *  once the restrictions of the list repeat.
+ **/
+template <int32_t N>
+class facet_index {
+ public:
+  /* The compatibility table of a sliceable set. */
+  struct table_t {
+    std::array<sliceable_set_t<N - 1>, num_facets(N)> projections;
+    // two bits per entry: computed and compatible
+    std::vector<uint64_t> computed;
+    std::vector<uint64_t> compatible;
+  };
+
+  facet_index(const std::vector<sliceable_set_t<N>>& sets,
+              const edge_lexicon_t<N>& edges)
+      : facet_edges_(compute_facet_edges<N>(edges)),
+        ids_(sets.size() * num_facets(N)) {
+    std::size_t num_ids = 0;
+    for (int32_t f = 0; f < num_facets(N); ++f) {
+      auto& projections = projections_[f];
+      projections.reserve(sets.size());
+      for (const auto& ss : sets) {
+        projections.push_back(project_to_facet<N>(ss, facet_edges_[f]));
+      }
+      std::sort(projections.begin(), projections.end());
+      projections.erase(std::unique(projections.begin(), projections.end()),
+                        projections.end());
+      projections.shrink_to_fit();
+      first_ids_[f] = static_cast<uint32_t>(num_ids);
+      for (std::size_t i = 0; i < sets.size(); ++i) {
+        const auto projection = project_to_facet<N>(sets[i], facet_edges_[f]);
+        const auto it = std::lower_bound(projections.begin(),
+                                         projections.end(), projection);
+        ids_[i * num_facets(N) + f] =
+            static_cast<uint32_t>(num_ids + (it - projections.begin()));
+      }
+      num_ids += projections.size();
+    }
+    num_entries_ = num_ids;
+  }
+
+  /**
+   *  Returns the number of distinct restrictions to a facet.
+   **/
+  std::size_t num_projections(int32_t f) const {
+    return projections_[f].size();
+  }
+
+  /**
+   *  Resets a compatibility table to a sliceable set.
+   **/
+  void reset_table(const sliceable_set_t<N>& ss, table_t& table) const {
+    for (int32_t f = 0; f < num_facets(N); ++f) {
+      table.projections[f] = project_to_facet<N>(ss, facet_edges_[f]);
+    }
+    table.computed.assign((num_entries_ + 63) / 64, 0);
+    table.compatible.assign((num_entries_ + 63) / 64, 0);
+  }
+
+  /**
+   *  Returns false if the union of the sliceable set of a compatibility table
+   *  and the i-th sliceable set of the list doesn't slice some facet and true
+   *  otherwise.
+   **/
+  bool may_slice_cube(table_t& table, std::size_t i) const {
+    const uint32_t* ids = ids_.data() + i * num_facets(N);
+    for (int32_t f = 0; f < num_facets(N); ++f) {
+      const std::size_t word = ids[f] / 64;
+      const uint64_t bit = uint64_t{1} << (ids[f] % 64);
+      if (!(table.computed[word] & bit)) {
+        const auto p = ids[f] - first_ids_[f];
+        table.computed[word] |= bit;
+        if ((table.projections[f] | projections_[f][p]).all()) {
+          table.compatible[word] |= bit;
+        }
+      }
+      if (!(table.compatible[word] & bit)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+ private:
+  facet_lexicon_t<N> facet_edges_;
+  std::array<std::vector<sliceable_set_t<N - 1>>, num_facets(N)> projections_;
+  // the number of the first restriction to a facet
+  std::array<uint32_t, num_facets(N)> first_ids_;
+  std::size_t num_entries_ = 0;
+  // ids_[i * num_facets(N) + f] numbers the restriction of the i-th sliceable
+  // set to facet f, counting the restrictions of all facets before f
+  std::vector<uint32_t> ids_;
+};
+
+/**
+ *  Returns true if any pairwise union of two ranges of sliceable sets slices
+ *  all edges and false otherwise.
+ *
+ *  The second range is required to be sorted in lexicographic order and to be
+ *  the list of the facet index. Pairs are rejected by their restrictions to
+ *  the facets before their full union is computed.
+ **/
+template <int32_t N>
+bool pairwise_unions_slice_cube(const sliceable_set_t<N>* sets_1_begin,
+                                const sliceable_set_t<N>* sets_1_end,
+                                const sliceable_set_t<N>* sets_2_begin,
+                                const sliceable_set_t<N>* sets_2_end,
+                                const facet_index<N>& index) {
+  typename facet_index<N>::table_t table;
+  for (auto set_1 = sets_1_begin; set_1 != sets_1_end; ++set_1) {
+    const int32_t leading_zeros = get_leading_zeros<N>(*set_1);
+    index.reset_table(*set_1, table);
+    for (auto set_2 = sets_2_end; set_2 != sets_2_begin;) {
+      --set_2;
+      const int32_t leading_ones = get_leading_ones<N>(*set_2);
+      if (leading_ones < leading_zeros) {
+        break;
+      }
+      const auto i = static_cast<std::size_t>(set_2 - sets_2_begin);
+      if (index.may_slice_cube(table, i) && (*set_1 | *set_2).all()) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+}  // namespace ncube
+
+#endif  // N_CUBE_FACET_H_
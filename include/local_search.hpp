@@ -0,0 +1,170 @@
+#ifndef N_CUBE_LOCAL_SEARCH_H_
+#define N_CUBE_LOCAL_SEARCH_H_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <vector>
+
+#include "edge.hpp"
+#include "sliceable_set.hpp"
+#include "thread_pool.hpp"
+
+namespace ncube {
+
+/**
+ *  Returns sliceable sets of a list that slice the n-cube, picked greedily by
+ *  the number of unsliced edges they slice, or an empty list if all sliceable
+ *  sets together don't slice the n-cube.
+ **/
+template <int32_t N>
+std::vector<sliceable_set_t<N>> greedy_cover(
+    const std::vector<sliceable_set_t<N>>& sets) {
+  std::vector<sliceable_set_t<N>> cover;
+  sliceable_set_t<N> sliced;
+  while (!sliced.all()) {
+    const sliceable_set_t<N>* best = nullptr;
+    std::size_t best_gain = 0;
+    for (const auto& ss : sets) {
+      const auto gain = (ss & ~sliced).count();
+      if (gain > best_gain) {
+        best = &ss;
+        best_gain = gain;
+      }
+    }
+    if (!best) {
+      return {};
+    }
+    cover.push_back(*best);
+    sliced |= *best;
+  }
+  return cover;
+}
+
+/**
+ *  Searches for k sliceable sets of a list that slice the n-cube by simulated
+ *  annealing and returns them, or an empty list if none are found within
+ *  num_steps steps per thread.
+ *
+ *  Every thread anneals its own k-tuple of sliceable sets, minimizing the
+ *  number of unsliced edges. A step replaces a random sliceable set of the
+ *  tuple by a random sliceable set that slices a random unsliced edge. The
+ *  change of the number of unsliced edges is computed from the edges sliced
+ *  at least once and exactly once by the tuple. The threads stop as soon as
+ *  one of them succeeds.
+ **/
+template <int32_t N>
+std::vector<sliceable_set_t<N>> local_search_cover(
+    const std::vector<sliceable_set_t<N>>& sets, int32_t k, uint64_t num_steps,
+    uint64_t seed = 0) {
+  if (k <= 0 || sets.empty()) {
+    return {};
+  }
+  // the sliceable sets that slice an edge by edge
+  std::vector<std::vector<uint32_t>> sets_of_edge(num_edges(N));
+  for (uint32_t i = 0; i < sets.size(); ++i) {
+    for (int32_t e = 0; e < num_edges(N); ++e) {
+      if (sets[i][e]) {
+        sets_of_edge[e].push_back(i);
+      }
+    }
+  }
+  std::atomic<bool> found(false);
+  std::vector<sliceable_set_t<N>> cover;
+  std::mutex cover_mutex;
+  const auto worker = [&](uint64_t thread_seed) {
+    std::mt19937_64 rng(thread_seed);
+    const auto random = [&rng](std::size_t m) {
+      return std::uniform_int_distribution<std::size_t>(0, m - 1)(rng);
+    };
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::vector<uint32_t> tuple(static_cast<std::size_t>(k));
+    std::array<int32_t, num_edges(N)> counts = {};
+    for (auto& i : tuple) {
+      i = static_cast<uint32_t>(random(sets.size()));
+      for (int32_t e = 0; e < num_edges(N); ++e) {
+        counts[e] += sets[i][e];
+      }
+    }
+    sliceable_set_t<N> sliced;
+    sliceable_set_t<N> sliced_once;
+    const auto update = [&]() {
+      for (int32_t e = 0; e < num_edges(N); ++e) {
+        sliced[e] = counts[e] >= 1;
+        sliced_once[e] = counts[e] == 1;
+      }
+    };
+    // stores the tuple as the cover if it slices the n-cube
+    const auto is_cover = [&]() {
+      if (!sliced.all()) {
+        return false;
+      }
+      found = true;
+      std::lock_guard<std::mutex> lock(cover_mutex);
+      cover.clear();
+      for (const auto i : tuple) {
+        cover.push_back(sets[i]);
+      }
+      return true;
+    };
+    update();
+    if (is_cover()) {
+      return;
+    }
+    constexpr double max_temperature = 2.0;
+    constexpr double min_temperature = 0.05;
+    for (uint64_t step = 0; step < num_steps && !found; ++step) {
+      const auto num_unsliced = num_edges(N) - sliced.count();
+      // a random unsliced edge
+      auto skip = random(num_unsliced);
+      int32_t edge = 0;
+      for (;; ++edge) {
+        if (!sliced[edge] && skip-- == 0) {
+          break;
+        }
+      }
+      const auto& candidates = sets_of_edge[edge];
+      if (candidates.empty()) {
+        break;
+      }
+      const auto pos = random(tuple.size());
+      const auto next = candidates[random(candidates.size())];
+      const auto& prev_set = sets[tuple[pos]];
+      const auto sliced_without = sliced & ~(prev_set & sliced_once);
+      const auto next_unsliced =
+          num_edges(N) - (sliced_without | sets[next]).count();
+      const double delta = static_cast<double>(next_unsliced) -
+                           static_cast<double>(num_unsliced);
+      const double progress =
+          static_cast<double>(step) / static_cast<double>(num_steps);
+      const double temperature =
+          max_temperature * (1 - progress) + min_temperature * progress;
+      if (delta <= 0 || uniform(rng) < std::exp(-delta / temperature)) {
+        for (int32_t e = 0; e < num_edges(N); ++e) {
+          counts[e] += sets[next][e] - prev_set[e];
+        }
+        tuple[pos] = next;
+        update();
+        if (is_cover()) {
+          break;
+        }
+      }
+    }
+  };
+  auto& pool = default_thread_pool();
+  const auto chain = [&](unsigned int, std::size_t begin, std::size_t end) {
+    for (auto i = begin; i < end; ++i) {
+      worker(seed * pool.size() + i);
+    }
+  };
+  pool.parallel_for(pool.size(), 1, chain);
+  return cover;
+}
+
+}  // namespace ncube
+
+#endif  // N_CUBE_LOCAL_SEARCH_H_
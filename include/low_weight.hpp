@@ -3,13 +3,16 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <filesystem>
+#include <fstream>
 #include <sstream>
 #include <string>
 #include <vector>
 
 #include "bitset_comparator.hpp"
 #include "edge.hpp"
+#include "external_sort.hpp"
 #include "prettyprint.hpp"
 #include "sliceable_set.hpp"
 #include "vertex.hpp"
@@ -27,17 +30,17 @@ sliceable_set_t<N> low_weight_halfspace_to_sliceable_set(
     const std::array<int32_t, N>& normal, int32_t threshold,
     const edge_lexicon_t<N>& edges) {
   sliceable_set_t<N> ss;
-  for (const auto& e : edges) {
+  for (int32_t e = 0; e < num_edges(N); ++e) {
     int32_t u_scalar = 0, v_scalar = 0;
     for (int32_t i = 0; i < N; ++i) {
-      const auto u_i = get_coordinate(e.first, i);
-      const auto v_i = get_coordinate(e.second, i);
+      const auto u_i = get_coordinate(edges[e].first, i);
+      const auto v_i = get_coordinate(edges[e].second, i);
       u_scalar += u_i * normal[i];
       v_scalar += v_i * normal[i];
     }
     if ((u_scalar < threshold && v_scalar > threshold) ||
         (u_scalar > threshold && v_scalar < threshold)) {
-      ss[edge_to_int<N>(e, edges)] = true;
+      ss[e] = true;
     }
   }
   return ss;
@@ -45,15 +48,17 @@ sliceable_set_t<N> low_weight_halfspace_to_sliceable_set(
 
 /**
  *  Changes a normal vector containing only values in {-1, 1} into the next
- *  normal vector containing only values in {-1, 1}.
+ *  normal vector containing only values in {-1, 1}. The first num_fixed
+ *  coordinates are left unchanged.
  *
  *  Returns true if the resulting normal vector is all -1 and false otherwise.
  *
  *  Naturally, the first call should be on a normal vector that is all -1.
  **/
 template <int32_t N>
-bool next_one_weight_vector(std::array<int32_t, N>& normal) {
-  for (auto it = normal.rbegin(); it != normal.rend(); ++it) {
+bool next_one_weight_vector(std::array<int32_t, N>& normal,
+                            int32_t num_fixed = 0) {
+  for (auto it = normal.rbegin(); it != normal.rend() - num_fixed; ++it) {
     if (*it == -1) {
       *it = 1;
       return true;
@@ -66,15 +71,17 @@ bool next_one_weight_vector(std::array<int32_t, N>& normal) {
 
 /**
  *  Changes a normal vector containing only values in {-max, ..., max} into the
- *  next normal vector containing only values in {-max, ..., max}.
+ *  next normal vector containing only values in {-max, ..., max}. The first
+ *  num_fixed coordinates are left unchanged.
  *
  *  Returns true if the resulting normal vector is all -max and false otherwise.
  *
  *  Naturally, the first call should be on a normal vector that is all -max.
  **/
 template <int32_t N>
-bool next_low_weight_vector(std::array<int32_t, N>& normal, int32_t max) {
-  for (auto it = normal.rbegin(); it != normal.rend(); ++it) {
+bool next_low_weight_vector(std::array<int32_t, N>& normal, int32_t max,
+                            int32_t num_fixed = 0) {
+  for (auto it = normal.rbegin(); it != normal.rend() - num_fixed; ++it) {
     if (*it == max) {
       *it = -max;
     } else {
@@ -85,6 +92,15 @@ bool next_low_weight_vector(std::array<int32_t, N>& normal, int32_t max) {
   return false;
 }
 
+/**
+ *  Returns true if a normal vector contains max or -max and false otherwise.
+ **/
+template <int32_t N>
+bool has_low_weight(const std::array<int32_t, N>& normal, int32_t max) {
+  const auto is_max = [max](int32_t x) { return x == max || x == -max; };
+  return std::any_of(normal.begin(), normal.end(), is_max);
+}
+
 /**
  *  Returns all maximal sliceable sets induced by low weight halfspaces
  *  satisfying the following:
@@ -96,7 +112,7 @@ bool next_low_weight_vector(std::array<int32_t, N>& normal, int32_t max) {
 template <int32_t N>
 std::vector<sliceable_set_t<N>> compute_one_weight_mss(
     const std::vector<int32_t>& thresholds, const edge_lexicon_t<N>& edges) {
-  std::vector<sliceable_set_t<N>> sets;
+  bit_sliced_family<num_edges(N)> family;
   std::array<int32_t, N> normal;
   normal.fill(-1);
   do {
@@ -104,20 +120,11 @@ std::vector<sliceable_set_t<N>> compute_one_weight_mss(
       const auto mss =
           low_weight_halfspace_to_sliceable_set<N>(normal, threshold, edges);
       if (mss.any()) {
-        const auto is_superset_of_mss = [mss](const sliceable_set_t<N>& ss) {
-          return (ss | mss) == ss;
-        };
-        if (std::none_of(sets.begin(), sets.end(), is_superset_of_mss)) {
-          const auto is_subset_of_mss = [mss](const sliceable_set_t<N>& ss) {
-            return (ss | mss) == mss;
-          };
-          const auto it = remove_if(sets.begin(), sets.end(), is_subset_of_mss);
-          sets.erase(it, sets.end());
-          sets.push_back(mss);
-        }
+        family.add_maximal(mss);
       }
     }
   } while (next_one_weight_vector<N>(normal));
+  auto sets = family.sets();
   std::sort(sets.begin(), sets.end());
   return sets;
 }
@@ -133,7 +140,7 @@ std::vector<sliceable_set_t<N>> compute_one_weight_mss(
 template <int32_t N>
 std::vector<sliceable_set_t<N>> compute_low_weight_mss(
     int32_t max, const edge_lexicon_t<N>& edges) {
-  std::vector<sliceable_set_t<N>> sets;
+  bit_sliced_family<num_edges(N)> family;
   std::array<int32_t, N> normal;
   normal.fill(-max);
   do {
@@ -141,20 +148,52 @@ std::vector<sliceable_set_t<N>> compute_low_weight_mss(
       const auto mss =
           low_weight_halfspace_to_sliceable_set<N>(normal, threshold, edges);
       if (mss.any()) {
-        const auto is_superset_of_mss = [mss](const sliceable_set_t<N>& ss) {
-          return (ss | mss) == ss;
-        };
-        if (std::none_of(sets.begin(), sets.end(), is_superset_of_mss)) {
-          const auto is_subset_of_mss = [mss](const sliceable_set_t<N>& ss) {
-            return (ss | mss) == mss;
-          };
-          const auto it = remove_if(sets.begin(), sets.end(), is_subset_of_mss);
-          sets.erase(it, sets.end());
-          sets.push_back(mss);
-        }
+        family.add_maximal(mss);
       }
     }
   } while (next_low_weight_vector<N>(normal, max));
+  auto sets = family.sets();
+  std::sort(sets.begin(), sets.end());
+  return sets;
+}
+
+/**
+ *  Returns all maximal sliceable sets induced by low weight halfspaces
+ *  satisfying the following:
+ *    - The normal vector contains only values in {-max, ..., max}.
+ *    - The threshold (distance to the origin) is any integer value.
+ *
+ *  Instead of enumerating all normal vectors, the maximal sliceable sets for
+ *  the normal vectors in {-(max - 1), ..., max - 1} are extended by the
+ *  sliceable sets of the normal vectors that contain max or -max. The previous
+ *  normal vectors don't slice any edge for the thresholds that were added, as
+ *  their scalar products with any vertex are at most (max - 1) * N.
+ *
+ *  The returned sliceable sets are sorted in lexicographic order.
+ **/
+template <int32_t N>
+std::vector<sliceable_set_t<N>> compute_low_weight_mss(
+    int32_t max, const std::vector<sliceable_set_t<N>>& prev_mss,
+    const edge_lexicon_t<N>& edges) {
+  bit_sliced_family<num_edges(N)> family;
+  for (const auto& ss : prev_mss) {
+    family.add(ss);
+  }
+  std::array<int32_t, N> normal;
+  normal.fill(-max);
+  do {
+    if (!has_low_weight<N>(normal, max)) {
+      continue;
+    }
+    for (int32_t threshold = 0; threshold < max * N; ++threshold) {
+      const auto mss =
+          low_weight_halfspace_to_sliceable_set<N>(normal, threshold, edges);
+      if (mss.any()) {
+        family.add_maximal(mss);
+      }
+    }
+  } while (next_low_weight_vector<N>(normal, max));
+  auto sets = family.sets();
   std::sort(sets.begin(), sets.end());
   return sets;
 }
@@ -231,6 +270,163 @@ void write_low_weight_halfspaces_to_file(int32_t max,
   }
 }
 
+/* The bitstring encoding of a sliceable set (see sliceable_set_bytes_t)
+ * followed by one byte for every coordinate of the normal vector and one byte
+ * for the threshold of the halfspace inducing it. The values are offset by 128
+ * so that sorting records bytewise sorts them by sliceable set first and then
+ * numerically by normal vector and threshold.
+ */
+template <int32_t N>
+using halfspace_record_t =
+    record_t<min_bytes_to_represent_bits(num_edges(N)) + N + 1>;
+
+/**
+ *  Returns the record of a sliceable set induced by a low weight halfspace.
+ *
+ *  The normal vector and the threshold must contain only values in
+ *  {-128, ..., 127}.
+ **/
+template <int32_t N>
+halfspace_record_t<N> halfspace_to_record(const sliceable_set_t<N>& ss,
+                                          const std::array<int32_t, N>& normal,
+                                          int32_t threshold) {
+  halfspace_record_t<N> record;
+  const auto bytes = sliceable_set_to_bytes<N>(ss);
+  std::memcpy(record.data(), bytes.data(), bytes.size());
+  for (int32_t i = 0; i < N; ++i) {
+    record[bytes.size() + i] = static_cast<char>(normal[i] + 128);
+  }
+  record.back() = static_cast<char>(threshold + 128);
+  return record;
+}
+
+/**
+ *  Decodes the record of a sliceable set induced by a low weight halfspace.
+ **/
+template <int32_t N>
+void record_to_halfspace(const halfspace_record_t<N>& record,
+                         sliceable_set_t<N>& ss,
+                         std::array<int32_t, N>& normal, int32_t& threshold) {
+  sliceable_set_bytes_t<N> bytes;
+  std::memcpy(bytes.data(), record.data(), bytes.size());
+  ss = bytes_to_sliceable_set<N>(bytes);
+  for (int32_t i = 0; i < N; ++i) {
+    normal[i] = static_cast<unsigned char>(record[bytes.size() + i]) - 128;
+  }
+  threshold = static_cast<unsigned char>(record.back()) - 128;
+}
+
+/**
+ *  Writes in lexicographic order all sliceable sets induced by low weight
+ *  halfspaces satisfying the following to a file at the given path:
+ *    - The normal vector contains only values in {-1, 1}.
+ *    - The threshold (distance to the origin) is one of the given thresholds.
+ *
+ *  For each sliceable set a halfspace_record_t is written in binary. At most
+ *  buffer_bytes of records are held in memory, the rest is sorted out of core
+ *  in a temporary directory next to the file.
+ **/
+template <int32_t N>
+void write_one_weight_halfspace_records_to_file(
+    const std::vector<int32_t>& thresholds, const edge_lexicon_t<N>& edges,
+    const std::filesystem::path& path,
+    std::size_t buffer_bytes = default_sort_buffer_bytes) {
+  const auto tmp_dir = path.string() + ".runs";
+  {
+    external_sorter<sizeof(halfspace_record_t<N>)> sorter(tmp_dir,
+                                                          buffer_bytes);
+    std::array<int32_t, N> normal;
+    normal.fill(-1);
+    do {
+      for (const auto& threshold : thresholds) {
+        const auto ss =
+            low_weight_halfspace_to_sliceable_set<N>(normal, threshold, edges);
+        if (ss.any()) {
+          sorter.push(halfspace_to_record<N>(ss, normal, threshold));
+        }
+      }
+    } while (next_one_weight_vector<N>(normal));
+    merge_runs_to_file<sizeof(halfspace_record_t<N>)>(sorter.finish(), false,
+                                                      path);
+  }
+  std::filesystem::remove_all(tmp_dir);
+}
+
+/**
+ *  Writes in lexicographic order all sliceable sets induced by low weight
+ *  halfspaces satisfying the following to a file at the given path:
+ *    - The normal vector contains only values in {-max, ..., max}.
+ *    - The threshold (distance to the origin) is any integer value.
+ *
+ *  For each sliceable set a halfspace_record_t is written in binary. At most
+ *  buffer_bytes of records are held in memory, the rest is sorted out of core
+ *  in a temporary directory next to the file.
+ **/
+template <int32_t N>
+void write_low_weight_halfspace_records_to_file(
+    int32_t max, const edge_lexicon_t<N>& edges,
+    const std::filesystem::path& path,
+    std::size_t buffer_bytes = default_sort_buffer_bytes) {
+  const auto tmp_dir = path.string() + ".runs";
+  {
+    external_sorter<sizeof(halfspace_record_t<N>)> sorter(tmp_dir,
+                                                          buffer_bytes);
+    std::array<int32_t, N> normal;
+    normal.fill(-max);
+    do {
+      for (int32_t threshold = 0; threshold < max * N; ++threshold) {
+        const auto ss =
+            low_weight_halfspace_to_sliceable_set<N>(normal, threshold, edges);
+        if (ss.any()) {
+          sorter.push(halfspace_to_record<N>(ss, normal, threshold));
+        }
+      }
+    } while (next_low_weight_vector<N>(normal, max));
+    merge_runs_to_file<sizeof(halfspace_record_t<N>)>(sorter.finish(), false,
+                                                      path);
+  }
+  std::filesystem::remove_all(tmp_dir);
+}
+
+/**
+ *  Converts a file of halfspace records to the text format written by
+ *  write_one_weight_halfspaces_to_file and write_low_weight_halfspaces_to_file.
+ *
+ *  The records are required to be sorted (by sliceable set).
+ **/
+template <int32_t N>
+void halfspace_records_to_text(const std::filesystem::path& in,
+                               const std::filesystem::path& out) {
+  std::ifstream in_file(in, std::ios::binary);
+  std::ofstream out_file(out);
+  // The text output sorts lines by their string representation, which only
+  // differs from the record order among the halfspaces of a sliceable set.
+  std::vector<std::string> lines;
+  sliceable_set_t<N> prev_ss;
+  const auto flush = [&]() {
+    std::sort(lines.begin(), lines.end());
+    for (const auto& str : lines) {
+      out_file << str << std::endl;
+    }
+    lines.clear();
+  };
+  halfspace_record_t<N> record;
+  while (in_file.read(record.data(), record.size())) {
+    sliceable_set_t<N> ss;
+    std::array<int32_t, N> normal;
+    int32_t threshold;
+    record_to_halfspace<N>(record, ss, normal, threshold);
+    if (ss != prev_ss) {
+      flush();
+      prev_ss = ss;
+    }
+    std::stringstream str_stream;
+    str_stream << ss << " " << normal << " " << threshold;
+    lines.push_back(str_stream.str());
+  }
+  flush();
+}
+
 }  // namespace ncube
 
 #endif  // N_CUBE_LOW_WEIGHT_H_
@@ -0,0 +1,51 @@
+#ifndef N_CUBE_LOWER_BOUND_H_
+#define N_CUBE_LOWER_BOUND_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "edge.hpp"
+#include "sliceable_set.hpp"
+
+namespace ncube {
+
+/**
+ *  Returns the largest number of edges sliced by a sliceable set of a list.
+ **/
+template <int32_t N>
+int32_t max_sliced_edges(const std::vector<sliceable_set_t<N>>& sets) {
+  std::size_t max_count = 0;
+  for (const auto& ss : sets) {
+    max_count = std::max(max_count, ss.count());
+  }
+  return static_cast<int32_t>(max_count);
+}
+
+/**
+ *  Returns a lower bound on the number of sliceable sets that slice the
+ *  n-cube, given that no union of j of them slices more than max_sliced edges.
+ *
+ *  k sliceable sets can be grouped into ceil(k / j) unions of at most j
+ *  sliceable sets, so k sliceable sets slice the n-cube only if
+ *  ceil(k / j) * max_sliced >= num_edges(N). If max_sliced is zero, no number
+ *  of sliceable sets suffices and num_edges(N) + 1 is returned.
+ *
+ *  For j = 1 this is also the optimum of the fractional set cover LP over a
+ *  symmetric family: The n-cube is edge-transitive, so averaging a fractional
+ *  cover over all transformations gives an optimal cover that is constant on
+ *  orbits, and such a cover is cheapest if it only uses the largest sliceable
+ *  sets.
+ **/
+template <int32_t N>
+int32_t union_lower_bound(int32_t j, int32_t max_sliced) {
+  if (max_sliced <= 0) {
+    return num_edges(N) + 1;
+  }
+  const int32_t num_unions = (num_edges(N) + max_sliced - 1) / max_sliced;
+  return j * (num_unions - 1) + 1;
+}
+
+}  // namespace ncube
+
+#endif  // N_CUBE_LOWER_BOUND_H_
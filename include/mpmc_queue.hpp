@@ -0,0 +1,125 @@
+#ifndef N_CUBE_MPMC_QUEUE_H_
+#define N_CUBE_MPMC_QUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <utility>
+
+namespace ncube {
+
+/**
+ *  A bounded lock-free queue for multiple producers and multiple consumers
+ *  (Dmitry Vyukov's algorithm).
+ *
+ *  Every cell carries a sequence number that tells producers and consumers
+ *  whether it is free or filled for their position, so a push or pop costs a
+ *  single compare-and-swap of the enqueue or dequeue position. The capacity is
+ *  rounded up to a power of two.
+ **/
+template <typename T>
+class mpmc_queue {
+ public:
+  explicit mpmc_queue(std::size_t min_capacity) {
+    std::size_t capacity = 2;
+    while (capacity < min_capacity) {
+      capacity *= 2;
+    }
+    mask_ = capacity - 1;
+    cells_.reset(new cell_t[capacity]);
+    for (std::size_t i = 0; i < capacity; ++i) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  mpmc_queue(const mpmc_queue&) = delete;
+  mpmc_queue& operator=(const mpmc_queue&) = delete;
+
+  /**
+   *  Pushes an item and returns true unless the queue is full.
+   **/
+  bool try_push(T& item) {
+    std::size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    for (;;) {
+      cell_t& cell = cells_[pos & mask_];
+      const auto seq = cell.sequence.load(std::memory_order_acquire);
+      const auto diff =
+          static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+      if (diff == 0) {
+        if (enqueue_pos_.compare_exchange_weak(pos, pos + 1,
+                                               std::memory_order_relaxed)) {
+          cell.item = std::move(item);
+          cell.sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /**
+   *  Pops an item and returns true unless the queue is empty.
+   **/
+  bool try_pop(T& item) {
+    std::size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+    for (;;) {
+      cell_t& cell = cells_[pos & mask_];
+      const auto seq = cell.sequence.load(std::memory_order_acquire);
+      const auto diff = static_cast<std::ptrdiff_t>(seq) -
+                        static_cast<std::ptrdiff_t>(pos + 1);
+      if (diff == 0) {
+        if (dequeue_pos_.compare_exchange_weak(pos, pos + 1,
+                                               std::memory_order_relaxed)) {
+          item = std::move(cell.item);
+          cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = dequeue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /**
+   *  Pushes an item, yielding while the queue is full.
+   **/
+  void push(T item) {
+    while (!try_push(item)) {
+      std::this_thread::yield();
+    }
+  }
+
+  /**
+   *  Returns the number of items in the queue. The result is only a snapshot
+   *  if other threads access the queue.
+   **/
+  std::size_t size() const {
+    const auto enqueue_pos = enqueue_pos_.load(std::memory_order_relaxed);
+    const auto dequeue_pos = dequeue_pos_.load(std::memory_order_relaxed);
+    return (enqueue_pos > dequeue_pos) ? enqueue_pos - dequeue_pos : 0;
+  }
+
+  std::size_t capacity() const { return mask_ + 1; }
+
+ private:
+  struct cell_t {
+    std::atomic<std::size_t> sequence;
+    T item;
+  };
+
+  std::unique_ptr<cell_t[]> cells_;
+  std::size_t mask_;
+  // separate cache lines for producers and consumers
+  alignas(64) std::atomic<std::size_t> enqueue_pos_{0};
+  alignas(64) std::atomic<std::size_t> dequeue_pos_{0};
+};
+
+}  // namespace ncube
+
+#endif  // N_CUBE_MPMC_QUEUE_H_
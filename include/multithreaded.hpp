@@ -2,91 +2,177 @@
 #define N_CUBE_MULTITHREADED_H_
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
 #include <thread>
+#include <unordered_set>
 #include <vector>
 
 #include "bitset_comparator.hpp"
 #include "edge.hpp"
+#include "external_sort.hpp"
+#include "low_weight.hpp"
+#include "mpmc_queue.hpp"
+#include "numa.hpp"
+#include "set_file.hpp"
+#include "signature.hpp"
+#include "thread_pool.hpp"
+#include "tiled_scan.hpp"
 #include "sliceable_set.hpp"
 #include "vertex.hpp"
 
 namespace ncube {
 
-/**
- *  Returns a balanced distribution of m units of work across num_threads
- *  workers.
- *
- *  For example, assign_workload(15, 4) returns {4, 4, 4, 3}.
- **/
-std::vector<std::size_t> assign_workload(std::size_t m,
-                                         unsigned int num_threads) {
-  std::vector<std::size_t> work_loads(num_threads, m / num_threads);
-  for (std::size_t i = 0; i < m % num_threads; ++i) {
-    ++work_loads[i];
+/* The queue depths of a pipelined computation of pairwise unions, sampled at
+ * every push, and the number of unions passing through it. */
+struct union_pipeline_stats_t {
+  uint64_t num_unions = 0;
+  uint64_t num_usr = 0;
+  uint64_t num_samples = 0;
+  uint64_t sum_depths = 0;
+  std::size_t max_depth = 0;
+
+  double mean_depth() const {
+    return num_samples ? static_cast<double>(sum_depths) /
+                             static_cast<double>(num_samples)
+                       : 0.0;
   }
-  return work_loads;
-}
+};
 
 /**
- *  Stores the unique symmetric representatives of the pairwise unions of two
- *  lists of sliceable sets in a range. Does NOT discard duplicates.
+ *  Returns a hash of a sliceable set that is invariant under all symmetric
+ *  transformations: the number of edges and the sorted numbers of edges in
+ *  every direction.
  **/
 template <int32_t N>
-void pairwise_unions_all(
-    typename std::vector<sliceable_set_t<N>>::const_iterator sets_1_begin,
-    typename std::vector<sliceable_set_t<N>>::const_iterator sets_1_end,
-    typename std::vector<sliceable_set_t<N>>::const_iterator sets_2_begin,
-    typename std::vector<sliceable_set_t<N>>::const_iterator sets_2_end,
-    typename std::vector<sliceable_set_t<N>>::iterator unions_begin,
-    const edge_lexicon_t<N>& edges) {
-  auto unions_it = unions_begin;
-  for (auto set_1 = sets_1_begin; set_1 != sets_1_end; ++set_1) {
-    for (auto set_2 = sets_2_begin; set_2 != sets_2_end; ++set_2) {
-      *unions_it = unique_sliceable_set<N>(*set_1 | *set_2, edges);
-      ++unions_it;
-    }
+std::size_t symmetry_invariant_hash(const sliceable_set_t<N>& ss,
+                                    const direction_masks_t<N>& masks) {
+  auto signature = compute_signature<N>(ss, masks);
+  std::sort(signature.begin(), signature.end());
+  std::size_t hash = ss.count();
+  for (const auto x : signature) {
+    hash = hash * 1000003 + static_cast<std::size_t>(x);
   }
+  return hash;
 }
 
 /**
  *  Returns the unique symmetric representatives of the pairwise unions of two
  *  lists of sliceable sets.
  *
- *  This function is parallelized but requires a significant amount of memory.
+ *  The unions flow through a pipeline: Generator threads compute the unions
+ *  of the rows of sets_1 and route them in chunks to lock-free queues, one
+ *  per canonicalizer thread, by a hash that is invariant under all symmetric
+ *  transformations. Hence all unions with the same unique symmetric
+ *  representative reach the same canonicalizer, which discards duplicates in
+ *  its own shard of the result without any locks. Only the queues bound the
+ *  memory in flight, instead of materializing all unions.
+ *
+ *  This function is parallelized.
  **/
 template <int32_t N>
 std::vector<sliceable_set_t<N>> pairwise_unions_parallel(
     const std::vector<sliceable_set_t<N>>& sets_1,
     const std::vector<sliceable_set_t<N>>& sets_2,
-    const edge_lexicon_t<N>& edges) {
-  // ensure effective parallelization
-  if (sets_1.size() > sets_2.size()) {
-    return pairwise_unions_parallel<N>(sets_2, sets_1, edges);
-  }
-  // divide mss
-  const unsigned int num_threads = std::thread::hardware_concurrency();
-  const auto set_1_workload = assign_workload(sets_2.size(), num_threads);
-  // compute the unique symmetric representatives of all pairwise unions
-  std::vector<sliceable_set_t<N>> unions(sets_1.size() * sets_2.size());
-  std::vector<std::thread> threads;
-  std::size_t prev_workload = 0;
-  for (unsigned int i = 0; i < num_threads; ++i) {
-    const auto unions_begin = unions.begin() + prev_workload * sets_1.size();
-    const auto set_1_begin = sets_2.begin() + prev_workload;
-    const auto sets_1_end = sets_2.begin() + prev_workload + set_1_workload[i];
-    threads.push_back(std::thread(pairwise_unions_all<N>, sets_1.begin(),
-                                  sets_1.end(), set_1_begin, sets_1_end,
-                                  unions_begin, edges));
-    prev_workload += set_1_workload[i];
-  }
-  for (auto& t : threads) {
-    t.join();
-  }
-  // discard duplicates
+    const edge_lexicon_t<N>& edges, union_pipeline_stats_t* stats = nullptr) {
+  using chunk_t = std::vector<sliceable_set_t<N>>;
+  constexpr std::size_t chunk_size = 64;
+  auto& pool = default_thread_pool();
+  // computing a union is much cheaper than its representative
+  const unsigned int num_generators = std::max(pool.size() / 8, 1u);
+  const unsigned int num_canonicalizers =
+      std::max(pool.size() - num_generators, 1u);
+  const auto masks = compute_direction_masks<N>(edges);
+  std::vector<std::unique_ptr<mpmc_queue<chunk_t>>> queues;
+  for (unsigned int i = 0; i < num_canonicalizers; ++i) {
+    queues.push_back(std::make_unique<mpmc_queue<chunk_t>>(16));
+  }
+  std::vector<std::unordered_set<sliceable_set_t<N>>> shards(
+      num_canonicalizers);
+  std::vector<union_pipeline_stats_t> generator_stats(num_generators);
+  std::atomic<std::size_t> next_row(0);
+  std::atomic<unsigned int> num_running(num_generators);
+  const auto generator = [&](unsigned int g) {
+    auto& local_stats = generator_stats[g];
+    std::vector<chunk_t> chunks(num_canonicalizers);
+    const auto flush = [&](unsigned int c) {
+      const auto depth = queues[c]->size();
+      ++local_stats.num_samples;
+      local_stats.sum_depths += depth;
+      local_stats.max_depth = std::max(local_stats.max_depth, depth);
+      queues[c]->push(std::move(chunks[c]));
+      chunks[c] = chunk_t();
+      chunks[c].reserve(chunk_size);
+    };
+    for (auto i = next_row++; i < sets_1.size(); i = next_row++) {
+      for (const auto& set_2 : sets_2) {
+        const auto ss = sets_1[i] | set_2;
+        const auto c = static_cast<unsigned int>(
+            symmetry_invariant_hash<N>(ss, masks) % num_canonicalizers);
+        chunks[c].push_back(ss);
+        if (chunks[c].size() == chunk_size) {
+          flush(c);
+        }
+      }
+      local_stats.num_unions += sets_2.size();
+    }
+    for (unsigned int c = 0; c < num_canonicalizers; ++c) {
+      if (!chunks[c].empty()) {
+        flush(c);
+      }
+    }
+    --num_running;
+  };
+  const auto canonicalizer = [&](unsigned int c) {
+    auto& shard = shards[c];
+    chunk_t chunk;
+    for (;;) {
+      // the generators are done before the last pop if num_running is 0
+      const bool done = num_running == 0;
+      if (!queues[c]->try_pop(chunk)) {
+        if (done) {
+          return;
+        }
+        std::this_thread::yield();
+        continue;
+      }
+      for (const auto& ss : chunk) {
+        shard.insert(unique_sliceable_set<N>(ss, edges));
+      }
+    }
+  };
+  // the stages wait for each other
+  pool.run_concurrently(num_generators + num_canonicalizers,
+                        [&](unsigned int t) {
+                          if (t < num_generators) {
+                            generator(t);
+                          } else {
+                            canonicalizer(t - num_generators);
+                          }
+                        });
+  // the shards are disjoint
+  std::vector<sliceable_set_t<N>> unions;
+  for (auto& shard : shards) {
+    unions.insert(unions.end(), shard.begin(), shard.end());
+    shard = {};
+  }
   std::sort(unions.begin(), unions.end());
-  auto unions_end = std::unique(unions.begin(), unions.end());
+  if (stats) {
+    *stats = union_pipeline_stats_t();
+    for (const auto& local_stats : generator_stats) {
+      stats->num_unions += local_stats.num_unions;
+      stats->num_samples += local_stats.num_samples;
+      stats->sum_depths += local_stats.sum_depths;
+      stats->max_depth = std::max(stats->max_depth, local_stats.max_depth);
+    }
+    stats->num_usr = unions.size();
+  }
   // discard subsets
+  auto unions_end = unions.end();
   for (auto it = unions.begin(); it != unions_end;) {
     const auto is_superset_of_it = [it](const sliceable_set_t<N>& ss) {
       return (*it | ss) == ss;
@@ -103,6 +189,470 @@ std::vector<sliceable_set_t<N>> pairwise_unions_parallel(
   return unions;
 }
 
+/**
+ *  Reserves capacity for n elements in an empty vector and touches its memory
+ *  in parallel, every participant of the default thread pool the pages of its
+ *  block of elements. The kernel places a page on the NUMA node of the thread
+ *  that touches it first, so parallel loops over the vector in the same blocks
+ *  read local memory if the threads are pinned.
+ *
+ *  This only has an effect if the capacity is fresh memory of the kernel, as
+ *  for large vectors.
+ **/
+template <typename T>
+void first_touch_reserve(std::vector<T>& v, std::size_t n) {
+  v.reserve(n);
+  auto& pool = default_thread_pool();
+  const auto bytes = reinterpret_cast<volatile char*>(v.data());
+  const auto block = (n + pool.size() - 1) / pool.size();
+  const auto touch = [&](unsigned int, std::size_t begin, std::size_t end) {
+    const auto end_byte = end * sizeof(T);
+    for (auto b = begin * sizeof(T); b < end_byte; b += numa_page_bytes) {
+      bytes[b] = 0;
+    }
+  };
+  pool.parallel_for(n, block, touch);
+}
+
+/**
+ *  Parallelized version of read_from_file.
+ *
+ *  Every participant of the default thread pool reads its block of the
+ *  sliceable sets into memory it touched first (see first_touch_reserve).
+ **/
+template <int32_t N>
+std::vector<sliceable_set_t<N>> read_from_file_parallel(
+    const std::filesystem::path& path) {
+  constexpr std::size_t set_bytes = sizeof(sliceable_set_bytes_t<N>);
+  const auto num_sets = std::filesystem::file_size(path) / set_bytes;
+  std::vector<sliceable_set_t<N>> sets;
+  first_touch_reserve(sets, num_sets);
+  sets.resize(num_sets);
+  auto& pool = default_thread_pool();
+  const auto block = (num_sets + pool.size() - 1) / pool.size();
+  const auto read = [&](unsigned int, std::size_t begin, std::size_t end) {
+    std::ifstream file(path, std::ios::binary);
+    file.seekg(static_cast<std::streamoff>(begin * set_bytes));
+    sliceable_set_bytes_t<N> bytes;
+    for (auto i = begin; i < end; ++i) {
+      file.read(bytes.data(), bytes.size());
+      sets[i] = bytes_to_sliceable_set<N>(bytes);
+    }
+  };
+  pool.parallel_for(num_sets, block, read);
+  return sets;
+}
+
+/**
+ *  Returns the sliceable sets of a set file, copied in parallel into memory
+ *  first touched by the participants of the default thread pool (see
+ *  first_touch_reserve), so that parallel scans over the sliceable sets read
+ *  local memory if the threads are pinned.
+ **/
+template <int32_t N>
+std::vector<sliceable_set_t<N>> read_set_file_parallel(
+    const std::filesystem::path& path) {
+  const mapped_set_file<N> file(path);
+  std::vector<sliceable_set_t<N>> sets;
+  first_touch_reserve(sets, file.size());
+  sets.resize(file.size());
+  auto& pool = default_thread_pool();
+  const auto block = (file.size() + pool.size() - 1) / pool.size();
+  const auto copy = [&](unsigned int, std::size_t begin, std::size_t end) {
+    std::copy(file.begin() + begin, file.begin() + end, sets.begin() + begin);
+  };
+  pool.parallel_for(file.size(), block, copy);
+  return sets;
+}
+
+/**
+ *  Returns a copy of a list of sliceable sets in memory of every NUMA node,
+ *  made by the first participant of the default thread pool on the node, or
+ *  no copies if there is a single node. This only helps if the threads are
+ *  pinned and the list is small enough to be copied once per node.
+ **/
+template <int32_t N>
+std::vector<std::vector<sliceable_set_t<N>>> replicate_per_node(
+    const std::vector<sliceable_set_t<N>>& sets) {
+  auto& pool = default_thread_pool();
+  const auto num_nodes = numa_topology().size();
+  std::vector<std::vector<sliceable_set_t<N>>> replicas;
+  if (num_nodes > 1) {
+    replicas.resize(num_nodes);
+    pool.run_concurrently(pool.size(), [&](unsigned int t) {
+      const auto node = node_of_participant(t, pool.size(), num_nodes);
+      const auto prev_node =
+          (t == 0) ? num_nodes : node_of_participant(t - 1, pool.size(),
+                                                     num_nodes);
+      if (node != prev_node) {
+        replicas[node] = sets;
+      }
+    });
+  }
+  return replicas;
+}
+
+/**
+ *  Parallelized version of pairwise_unions_slice_cube.
+ *
+ *  The first range is split across the participants of the default thread
+ *  pool, each of which scans its part by pairwise_unions_slice_cube_tiled
+ *  against sets_2, or against the replica of sets_2 on its NUMA node if there
+ *  are replicas (see replicate_per_node).
+ *
+ *  sets_2 is required to be sorted in lexicographic order.
+ **/
+template <int32_t N>
+bool pairwise_unions_slice_cube_parallel(
+    const sliceable_set_t<N>* sets_1_begin,
+    const sliceable_set_t<N>* sets_1_end,
+    const std::vector<sliceable_set_t<N>>& sets_2,
+    const std::vector<std::vector<sliceable_set_t<N>>>& replicas) {
+  auto& pool = default_thread_pool();
+  std::atomic<bool> found(false);
+  const auto scan = [&](unsigned int i, std::size_t begin, std::size_t end) {
+    if (found) {
+      return;
+    }
+    const auto& local_sets_2 =
+        replicas.empty()
+            ? sets_2
+            : replicas[node_of_participant(i, pool.size(), replicas.size())];
+    if (pairwise_unions_slice_cube_tiled<N>(
+            sets_1_begin + begin, sets_1_begin + end, local_sets_2.data(),
+            local_sets_2.data() + local_sets_2.size())) {
+      found = true;
+    }
+  };
+  const auto num_sets_1 = static_cast<std::size_t>(sets_1_end - sets_1_begin);
+  pool.parallel_for(num_sets_1, 0, scan);
+  return found;
+}
+
+/**
+ *  Parallelized version of pairwise_unions_slice_cube. If replicate_sets_2 is
+ *  true, sets_2 is replicated on every NUMA node first (see
+ *  replicate_per_node).
+ **/
+template <int32_t N>
+bool pairwise_unions_slice_cube_parallel(
+    const std::vector<sliceable_set_t<N>>& sets_1,
+    const std::vector<sliceable_set_t<N>>& sets_2,
+    bool replicate_sets_2 = false) {
+  const auto replicas =
+      replicate_sets_2 ? replicate_per_node<N>(sets_2)
+                       : std::vector<std::vector<sliceable_set_t<N>>>();
+  return pairwise_unions_slice_cube_parallel<N>(
+      sets_1.data(), sets_1.data() + sets_1.size(), sets_2, replicas);
+}
+
+/**
+ *  Parallelized version of pairwise_unions_slice_cube for a second list
+ *  grouped by signature: the first list is split across the participants of
+ *  the default thread pool.
+ **/
+template <int32_t N>
+bool pairwise_unions_slice_cube_parallel(
+    const std::vector<sliceable_set_t<N>>& sets_1,
+    const signature_buckets<N>& sets_2) {
+  std::atomic<bool> found(false);
+  const auto scan = [&](unsigned int, std::size_t begin, std::size_t end) {
+    if (!found && pairwise_unions_slice_cube<N>(sets_1.data() + begin,
+                                                sets_1.data() + end, sets_2)) {
+      found = true;
+    }
+  };
+  default_thread_pool().parallel_for(sets_1.size(), 0, scan);
+  return found;
+}
+
+/**
+ *  Returns the smallest number of leading coordinates of a normal vector that
+ *  have to be fixed to split all normal vectors into at least min_parts
+ *  prefixes, where each coordinate takes one of num_values values. At most N
+ *  coordinates are fixed.
+ **/
+template <int32_t N>
+int32_t num_leading_coordinates(std::size_t num_values, std::size_t min_parts) {
+  int32_t num_fixed = 0;
+  std::size_t num_prefixes = 1;
+  while (num_fixed < N && num_prefixes < min_parts) {
+    num_prefixes *= num_values;
+    ++num_fixed;
+  }
+  return num_fixed;
+}
+
+/**
+ *  Returns the number of prefixes of num_fixed coordinates, where each
+ *  coordinate takes one of num_values values.
+ **/
+std::size_t num_normal_prefixes(std::size_t num_values, int32_t num_fixed) {
+  std::size_t num_prefixes = 1;
+  for (int32_t i = 0; i < num_fixed; ++i) {
+    num_prefixes *= num_values;
+  }
+  return num_prefixes;
+}
+
+/**
+ *  Returns the normal vector whose first num_fixed coordinates are the prefix
+ *  with the given index and whose other coordinates are the smallest value.
+ *
+ *  The prefixes are enumerated in the same order as next_low_weight_vector
+ *  enumerates normal vectors, given the values in increasing order.
+ **/
+template <int32_t N>
+std::array<int32_t, N> normal_prefix(std::size_t index, int32_t num_fixed,
+                                     const std::vector<int32_t>& values) {
+  std::array<int32_t, N> normal;
+  normal.fill(values.front());
+  for (int32_t i = num_fixed - 1; i >= 0; --i) {
+    normal[i] = values[index % values.size()];
+    index /= values.size();
+  }
+  return normal;
+}
+
+/**
+ *  Calls f(i, normal) for every normal vector containing only values in
+ *  {-max, ..., max}, where i is the index of the thread in the default thread
+ *  pool.
+ *
+ *  The normal vectors are split by their leading coordinates into chunks that
+ *  are balanced by work stealing.
+ **/
+template <int32_t N, typename F>
+void for_each_low_weight_vector_parallel(int32_t max, F f) {
+  auto& pool = default_thread_pool();
+  std::vector<int32_t> values;
+  for (int32_t x = -max; x <= max; ++x) {
+    values.push_back(x);
+  }
+  // more prefixes than threads balance the work of the individual prefixes
+  const auto num_fixed =
+      num_leading_coordinates<N>(values.size(), 8 * pool.size());
+  const auto num_prefixes = num_normal_prefixes(values.size(), num_fixed);
+  const auto worker = [&](unsigned int i, std::size_t begin, std::size_t end) {
+    for (auto prefix = begin; prefix < end; ++prefix) {
+      auto normal = normal_prefix<N>(prefix, num_fixed, values);
+      do {
+        f(i, normal);
+      } while (next_low_weight_vector<N>(normal, max, num_fixed));
+    }
+  };
+  pool.parallel_for(num_prefixes, 1, worker);
+}
+
+/**
+ *  Calls f(i, normal) for every normal vector containing only values in
+ *  {-1, 1}, where i is the index of the thread in the default thread pool.
+ *
+ *  The normal vectors are split by their leading coordinates into chunks that
+ *  are balanced by work stealing.
+ **/
+template <int32_t N, typename F>
+void for_each_one_weight_vector_parallel(F f) {
+  auto& pool = default_thread_pool();
+  const std::vector<int32_t> values = {-1, 1};
+  const auto num_fixed =
+      num_leading_coordinates<N>(values.size(), 8 * pool.size());
+  const auto num_prefixes = num_normal_prefixes(values.size(), num_fixed);
+  const auto worker = [&](unsigned int i, std::size_t begin, std::size_t end) {
+    for (auto prefix = begin; prefix < end; ++prefix) {
+      auto normal = normal_prefix<N>(prefix, num_fixed, values);
+      do {
+        f(i, normal);
+      } while (next_one_weight_vector<N>(normal, num_fixed));
+    }
+  };
+  pool.parallel_for(num_prefixes, 1, worker);
+}
+
+/**
+ *  Returns the maximal sliceable sets among the union of per-thread families
+ *  of maximal sliceable sets and the given previous maximal sliceable sets.
+ *
+ *  The returned sliceable sets are sorted in lexicographic order.
+ **/
+template <int32_t N>
+std::vector<sliceable_set_t<N>> merge_mss(
+    const std::vector<bit_sliced_family<num_edges(N)>>& thread_mss,
+    const std::vector<sliceable_set_t<N>>& prev_mss = {}) {
+  std::vector<sliceable_set_t<N>> sets = prev_mss;
+  for (const auto& mss : thread_mss) {
+    const auto thread_sets = mss.sets();
+    sets.insert(sets.end(), thread_sets.begin(), thread_sets.end());
+  }
+  return reduce_to_mss<N>(sets);
+}
+
+/**
+ *  Returns all maximal sliceable sets induced by low weight halfspaces
+ *  satisfying the following:
+ *    - The normal vector contains only values in {-1, 1}.
+ *    - The threshold (distance to the origin) is one of the given thresholds.
+ *
+ *  This function is parallelized. Every thread keeps its own maximal sliceable
+ *  sets which are merged at the end.
+ *
+ *  The returned sliceable sets are sorted in lexicographic order.
+ **/
+template <int32_t N>
+std::vector<sliceable_set_t<N>> compute_one_weight_mss_parallel(
+    const std::vector<int32_t>& thresholds, const edge_lexicon_t<N>& edges) {
+  const unsigned int num_threads = default_thread_pool().size();
+  std::vector<bit_sliced_family<num_edges(N)>> thread_mss(num_threads);
+  const auto f = [&](unsigned int i, const std::array<int32_t, N>& normal) {
+    for (const auto& threshold : thresholds) {
+      const auto mss =
+          low_weight_halfspace_to_sliceable_set<N>(normal, threshold, edges);
+      if (mss.any()) {
+        thread_mss[i].add_maximal(mss);
+      }
+    }
+  };
+  for_each_one_weight_vector_parallel<N>(f);
+  return merge_mss<N>(thread_mss);
+}
+
+/**
+ *  Returns all maximal sliceable sets induced by low weight halfspaces
+ *  satisfying the following:
+ *    - The normal vector contains only values in {-max, ..., max}.
+ *    - The threshold (distance to the origin) is any integer value.
+ *
+ *  If the maximal sliceable sets for {-(max - 1), ..., max - 1} are given, only
+ *  the normal vectors containing max or -max are enumerated (see the
+ *  sequential compute_low_weight_mss).
+ *
+ *  This function is parallelized. Every thread keeps its own maximal sliceable
+ *  sets which are merged at the end.
+ *
+ *  The returned sliceable sets are sorted in lexicographic order.
+ **/
+template <int32_t N>
+std::vector<sliceable_set_t<N>> compute_low_weight_mss_parallel(
+    int32_t max, const std::vector<sliceable_set_t<N>>& prev_mss,
+    const edge_lexicon_t<N>& edges) {
+  const unsigned int num_threads = default_thread_pool().size();
+  std::vector<bit_sliced_family<num_edges(N)>> thread_mss(num_threads);
+  const bool only_max = !prev_mss.empty();
+  const auto f = [&](unsigned int i, const std::array<int32_t, N>& normal) {
+    if (only_max && !has_low_weight<N>(normal, max)) {
+      return;
+    }
+    for (int32_t threshold = 0; threshold < max * N; ++threshold) {
+      const auto mss =
+          low_weight_halfspace_to_sliceable_set<N>(normal, threshold, edges);
+      if (mss.any()) {
+        thread_mss[i].add_maximal(mss);
+      }
+    }
+  };
+  for_each_low_weight_vector_parallel<N>(max, f);
+  return merge_mss<N>(thread_mss, prev_mss);
+}
+
+template <int32_t N>
+std::vector<sliceable_set_t<N>> compute_low_weight_mss_parallel(
+    int32_t max, const edge_lexicon_t<N>& edges) {
+  return compute_low_weight_mss_parallel<N>(max, {}, edges);
+}
+
+/**
+ *  Returns one external sorter of halfspace records per thread sharing a
+ *  buffer of buffer_bytes.
+ **/
+template <int32_t N>
+std::vector<external_sorter<sizeof(halfspace_record_t<N>)>>
+halfspace_record_sorters(unsigned int num_threads,
+                         const std::filesystem::path& tmp_dir,
+                         std::size_t buffer_bytes) {
+  std::vector<external_sorter<sizeof(halfspace_record_t<N>)>> sorters;
+  sorters.reserve(num_threads);
+  for (unsigned int i = 0; i < num_threads; ++i) {
+    sorters.emplace_back(tmp_dir, buffer_bytes / num_threads);
+  }
+  return sorters;
+}
+
+/**
+ *  Merges the runs of all external sorters into a file at the given path.
+ **/
+template <std::size_t R>
+void merge_sorters_to_file(std::vector<external_sorter<R>>& sorters,
+                           const std::filesystem::path& path) {
+  std::vector<std::filesystem::path> runs;
+  for (auto& sorter : sorters) {
+    const auto& sorter_runs = sorter.finish();
+    runs.insert(runs.end(), sorter_runs.begin(), sorter_runs.end());
+  }
+  merge_runs_to_file<R>(runs, false, path);
+}
+
+/**
+ *  Parallelized version of write_one_weight_halfspace_records_to_file.
+ *
+ *  Every thread sorts its records in its own runs, all runs are merged at the
+ *  end.
+ **/
+template <int32_t N>
+void write_one_weight_halfspace_records_to_file_parallel(
+    const std::vector<int32_t>& thresholds, const edge_lexicon_t<N>& edges,
+    const std::filesystem::path& path,
+    std::size_t buffer_bytes = default_sort_buffer_bytes) {
+  const unsigned int num_threads = default_thread_pool().size();
+  const auto tmp_dir = path.string() + ".runs";
+  {
+    auto sorters = halfspace_record_sorters<N>(num_threads, tmp_dir,
+                                               buffer_bytes);
+    const auto f = [&](unsigned int i, const std::array<int32_t, N>& normal) {
+      for (const auto& threshold : thresholds) {
+        const auto ss =
+            low_weight_halfspace_to_sliceable_set<N>(normal, threshold, edges);
+        if (ss.any()) {
+          sorters[i].push(halfspace_to_record<N>(ss, normal, threshold));
+        }
+      }
+    };
+    for_each_one_weight_vector_parallel<N>(f);
+    merge_sorters_to_file(sorters, path);
+  }
+  std::filesystem::remove_all(tmp_dir);
+}
+
+/**
+ *  Parallelized version of write_low_weight_halfspace_records_to_file.
+ *
+ *  Every thread sorts its records in its own runs, all runs are merged at the
+ *  end.
+ **/
+template <int32_t N>
+void write_low_weight_halfspace_records_to_file_parallel(
+    int32_t max, const edge_lexicon_t<N>& edges,
+    const std::filesystem::path& path,
+    std::size_t buffer_bytes = default_sort_buffer_bytes) {
+  const unsigned int num_threads = default_thread_pool().size();
+  const auto tmp_dir = path.string() + ".runs";
+  {
+    auto sorters = halfspace_record_sorters<N>(num_threads, tmp_dir,
+                                               buffer_bytes);
+    const auto f = [&](unsigned int i, const std::array<int32_t, N>& normal) {
+      for (int32_t threshold = 0; threshold < max * N; ++threshold) {
+        const auto ss =
+            low_weight_halfspace_to_sliceable_set<N>(normal, threshold, edges);
+        if (ss.any()) {
+          sorters[i].push(halfspace_to_record<N>(ss, normal, threshold));
+        }
+      }
+    };
+    for_each_low_weight_vector_parallel<N>(max, f);
+    merge_sorters_to_file(sorters, path);
+  }
+  std::filesystem::remove_all(tmp_dir);
+}
+
 }  // namespace ncube
 
 #endif  // N_CUBE_MULTITHREADED_H_
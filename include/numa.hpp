@@ -0,0 +1,118 @@
+#ifndef N_CUBE_NUMA_H_
+#define N_CUBE_NUMA_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace ncube {
+
+/* For every NUMA node the CPUs on the node. */
+using numa_topology_t = std::vector<std::vector<int32_t>>;
+
+/**
+ *  Returns the CPUs of a CPU list like "0-3,8,10-11" (see cpuset(7)).
+ **/
+std::vector<int32_t> parse_cpulist(const std::string& cpulist) {
+  std::vector<int32_t> cpus;
+  std::istringstream stream(cpulist);
+  std::string range;
+  while (std::getline(stream, range, ',')) {
+    if (range.empty() || range == "\n") {
+      continue;
+    }
+    const auto dash = range.find('-');
+    const auto first = std::stoi(range.substr(0, dash));
+    const auto last =
+        (dash == std::string::npos) ? first : std::stoi(range.substr(dash + 1));
+    for (int32_t cpu = first; cpu <= last; ++cpu) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+/**
+ *  Returns the NUMA nodes of the machine with their CPUs, read from sysfs.
+ *  Without NUMA information, all CPUs form a single node.
+ **/
+numa_topology_t compute_numa_topology() {
+  numa_topology_t nodes;
+  const std::filesystem::path sysfs = "/sys/devices/system/node";
+  for (int32_t node = 0;; ++node) {
+    std::ifstream file(sysfs / ("node" + std::to_string(node)) / "cpulist");
+    std::string cpulist;
+    if (!file || !std::getline(file, cpulist)) {
+      break;
+    }
+    auto cpus = parse_cpulist(cpulist);
+    // memory-only nodes have no CPUs to run on
+    if (!cpus.empty()) {
+      nodes.push_back(std::move(cpus));
+    }
+  }
+  if (nodes.empty()) {
+    nodes.emplace_back();
+    const auto num_cpus = static_cast<int32_t>(
+        std::max(std::thread::hardware_concurrency(), 1u));
+    for (int32_t cpu = 0; cpu < num_cpus; ++cpu) {
+      nodes.back().push_back(cpu);
+    }
+  }
+  return nodes;
+}
+
+/**
+ *  Returns the NUMA topology of the machine, computed once.
+ **/
+const numa_topology_t& numa_topology() {
+  static const numa_topology_t nodes = compute_numa_topology();
+  return nodes;
+}
+
+/**
+ *  Returns the node of the i-th of num_participants threads, where the threads
+ *  are spread over the nodes in contiguous blocks. This matches the blocks of
+ *  chunks a thread pool deals to its participants, so that a thread works on
+ *  data first touched by threads on its own node.
+ **/
+std::size_t node_of_participant(std::size_t i, std::size_t num_participants,
+                                std::size_t num_nodes) {
+  return i * num_nodes / num_participants;
+}
+
+/**
+ *  Restricts the calling thread to a set of CPUs. Returns false if this isn't
+ *  supported or fails and true otherwise.
+ **/
+bool pin_current_thread(const std::vector<int32_t>& cpus) {
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (const auto cpu : cpus) {
+    CPU_SET(cpu, &set);
+  }
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+  (void)cpus;
+  return false;
+#endif
+}
+
+/* The granularity in which the kernel places memory on the node of the thread
+ * that first touches it. */
+constexpr std::size_t numa_page_bytes = 4096;
+
+}  // namespace ncube
+
+#endif  // N_CUBE_NUMA_H_
@@ -0,0 +1,226 @@
+#ifndef N_CUBE_OUT_OF_CORE_H_
+#define N_CUBE_OUT_OF_CORE_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <stdexcept>
+#include <vector>
+
+#include "bitset_comparator.hpp"
+#include "edge.hpp"
+#include "external_sort.hpp"
+#include "multithreaded.hpp"
+#include "set_file.hpp"
+#include "sliceable_set.hpp"
+
+namespace ncube {
+
+/* The record of a sliceable set is its image (see sliceable_set_image_t), so
+ * that sorting records sorts sliceable sets in lexicographic order.
+ */
+template <int32_t N>
+using set_record_t = record_t<sizeof(sliceable_set_image_t<N>)>;
+
+template <int32_t N>
+set_record_t<N> sliceable_set_to_record(const sliceable_set_t<N>& ss) {
+  const auto image = sliceable_set_to_image<N>(ss);
+  set_record_t<N> record;
+  std::memcpy(record.data(), image.data(), image.size());
+  return record;
+}
+
+template <int32_t N>
+sliceable_set_t<N> record_to_sliceable_set(const set_record_t<N>& record) {
+  sliceable_set_image_t<N> image;
+  std::memcpy(image.data(), record.data(), image.size());
+  return image_to_sliceable_set<N>(image);
+}
+
+/**
+ *  Removes a directory of run files when it goes out of scope, also if an
+ *  error is thrown.
+ **/
+class run_dir_guard {
+ public:
+  explicit run_dir_guard(const std::filesystem::path& dir) : dir_(dir) {}
+
+  run_dir_guard(const run_dir_guard&) = delete;
+  run_dir_guard& operator=(const run_dir_guard&) = delete;
+
+  ~run_dir_guard() {
+    std::error_code ec;
+    std::filesystem::remove_all(dir_, ec);
+  }
+
+ private:
+  std::filesystem::path dir_;
+};
+
+/**
+ *  Returns one external sorter of sliceable set records per thread sharing a
+ *  buffer of buffer_bytes. The sorters discard duplicates.
+ **/
+template <int32_t N>
+std::vector<external_sorter<sizeof(set_record_t<N>)>> set_record_sorters(
+    unsigned int num_threads, const std::filesystem::path& tmp_dir,
+    std::size_t buffer_bytes) {
+  std::vector<external_sorter<sizeof(set_record_t<N>)>> sorters;
+  sorters.reserve(num_threads);
+  for (unsigned int i = 0; i < num_threads; ++i) {
+    sorters.emplace_back(tmp_dir, buffer_bytes / num_threads, true);
+  }
+  return sorters;
+}
+
+/**
+ *  Merges the runs of external sorters of sliceable set records into a set file
+ *  at the given path and returns the number of sliceable sets written.
+ *
+ *  Duplicates are discarded. If filter_window is positive, every sliceable set
+ *  that is a subset of one of the next filter_window sliceable sets is
+ *  discarded as well. Since a subset precedes its supersets in lexicographic
+ *  order, this eliminates non-maximal sliceable sets on a best effort basis.
+ *
+ *  The runs are merged with a bounded fan-in (see merge_runs), so any number
+ *  of runs can be merged. Throws if any run or the set file can't be read or
+ *  written, rather than leave out sliceable sets.
+ **/
+template <int32_t N>
+std::size_t merge_set_runs_to_file(
+    std::vector<external_sorter<sizeof(set_record_t<N>)>>& sorters,
+    const std::filesystem::path& path, uint32_t flags,
+    std::size_t filter_window) {
+  std::vector<std::filesystem::path> runs;
+  for (auto& sorter : sorters) {
+    const auto& sorter_runs = sorter.finish();
+    runs.insert(runs.end(), sorter_runs.begin(), sorter_runs.end());
+  }
+  set_file_writer<N> writer(path, flags);
+  std::size_t num_sets = 0;
+  std::deque<sliceable_set_t<N>> window;
+  const auto add = [&](const set_record_t<N>& record) {
+    const auto curr = record_to_sliceable_set<N>(record);
+    if (filter_window == 0) {
+      writer.write(curr);
+      ++num_sets;
+      return;
+    }
+    const auto is_subset_of_curr = [curr](const sliceable_set_t<N>& ss) {
+      return (curr | ss) == curr;
+    };
+    const auto it =
+        std::remove_if(window.begin(), window.end(), is_subset_of_curr);
+    window.erase(it, window.end());
+    window.push_back(curr);
+    if (window.size() > filter_window) {
+      writer.write(window.front());
+      window.pop_front();
+      ++num_sets;
+    }
+  };
+  merge_runs<sizeof(set_record_t<N>)>(runs, true, add);
+  for (const auto& ss : window) {
+    writer.write(ss);
+    ++num_sets;
+  }
+  writer.close();
+  // a set file with fewer sets than were merged would give wrong answers
+  if (std::filesystem::file_size(path) !=
+      set_file_data_offset + num_sets * sizeof(sliceable_set_t<N>)) {
+    throw std::runtime_error("incomplete set file " + path.string());
+  }
+  return num_sets;
+}
+
+/**
+ *  Writes the symmetry expansions of the unique symmetric representatives of
+ *  sliceable sets to a set file at the given path and returns their number.
+ *
+ *  The expansions are generated in parallel into sorted runs of at most
+ *  buffer_bytes in total in a temporary directory next to the file, which are
+ *  merged with deduplication. The written sliceable sets are sorted in
+ *  lexicographic order.
+ **/
+template <int32_t N>
+std::size_t expand_usr_to_file(
+    const sliceable_set_t<N>* usr_begin, const sliceable_set_t<N>* usr_end,
+    const edge_lexicon_t<N>& edges, const std::filesystem::path& path,
+    std::size_t buffer_bytes = default_sort_buffer_bytes) {
+  const unsigned int num_threads = default_thread_pool().size();
+  const auto tmp_dir = path.string() + ".runs";
+  const run_dir_guard guard(tmp_dir);
+  std::size_t num_sets;
+  {
+    auto sorters = set_record_sorters<N>(num_threads, tmp_dir, buffer_bytes);
+    const auto worker = [&](unsigned int i, std::size_t begin,
+                            std::size_t end) {
+      const auto add = [&sorters, i](const sliceable_set_t<N>& ss_trans) {
+        sorters[i].push(sliceable_set_to_record<N>(ss_trans));
+      };
+      for (auto ss = usr_begin + begin; ss != usr_begin + end; ++ss) {
+        for_each_transformation<N>(*ss, edges, add);
+      }
+    };
+    const auto num_usr = static_cast<std::size_t>(usr_end - usr_begin);
+    default_thread_pool().parallel_for(num_usr, 0, worker);
+    num_sets = merge_set_runs_to_file<N>(sorters, path,
+                                         set_file_sorted | set_file_mss, 0);
+  }
+  return num_sets;
+}
+
+/**
+ *  Writes the unique symmetric representatives of the pairwise unions of two
+ *  ranges of sliceable sets to a set file at the given path and returns their
+ *  number.
+ *
+ *  The unions are generated in parallel into sorted runs of at most
+ *  buffer_bytes in total in a temporary directory next to the file, which are
+ *  merged with deduplication. Non-maximal unions are eliminated within a window
+ *  of filter_window unions (see merge_set_runs_to_file). The written sliceable
+ *  sets are sorted in lexicographic order.
+ **/
+template <int32_t N>
+std::size_t pairwise_unions_to_file(
+    const sliceable_set_t<N>* sets_1_begin,
+    const sliceable_set_t<N>* sets_1_end,
+    const sliceable_set_t<N>* sets_2_begin,
+    const sliceable_set_t<N>* sets_2_end, const edge_lexicon_t<N>& edges,
+    const std::filesystem::path& path, std::size_t filter_window = 0,
+    std::size_t buffer_bytes = default_sort_buffer_bytes) {
+  // ensure effective parallelization
+  if (sets_1_end - sets_1_begin > sets_2_end - sets_2_begin) {
+    return pairwise_unions_to_file<N>(sets_2_begin, sets_2_end, sets_1_begin,
+                                      sets_1_end, edges, path, filter_window,
+                                      buffer_bytes);
+  }
+  const unsigned int num_threads = default_thread_pool().size();
+  const auto tmp_dir = path.string() + ".runs";
+  const run_dir_guard guard(tmp_dir);
+  std::size_t num_sets;
+  {
+    auto sorters = set_record_sorters<N>(num_threads, tmp_dir, buffer_bytes);
+    const auto worker = [&](unsigned int i, std::size_t begin,
+                            std::size_t end) {
+      for (auto set_2 = sets_2_begin + begin; set_2 != sets_2_begin + end;
+           ++set_2) {
+        for (auto set_1 = sets_1_begin; set_1 != sets_1_end; ++set_1) {
+          const auto usr = unique_sliceable_set<N>(*set_1 | *set_2, edges);
+          sorters[i].push(sliceable_set_to_record<N>(usr));
+        }
+      }
+    };
+    const auto num_sets_2 = static_cast<std::size_t>(sets_2_end - sets_2_begin);
+    default_thread_pool().parallel_for(num_sets_2, 0, worker);
+    num_sets = merge_set_runs_to_file<N>(
+        sorters, path, set_file_sorted | set_file_usr, filter_window);
+  }
+  return num_sets;
+}
+
+}  // namespace ncube
+
+#endif  // N_CUBE_OUT_OF_CORE_H_
@@ -0,0 +1,364 @@
+#ifndef N_CUBE_PACKED_SET_H_
+#define N_CUBE_PACKED_SET_H_
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <vector>
+
+#include "edge.hpp"
+#include "sliceable_set.hpp"
+#include "vertex.hpp"
+
+namespace ncube {
+
+/* GCC and Clang provide 128-bit integers as an extension. */
+__extension__ typedef unsigned __int128 uint128_t;
+
+/* The number of 64-bit words needed for the sliceable sets of the n-cube. */
+constexpr std::size_t num_packed_words(int32_t n) {
+  return (static_cast<std::size_t>(num_edges(n)) + 63) / 64;
+}
+
+/**
+ *  Returns the number of leading 0-bits of a word.
+ **/
+int32_t count_leading_zeros(uint64_t word) {
+  return word ? __builtin_clzll(word) : 64;
+}
+
+int32_t count_leading_zeros(uint128_t word) {
+  const auto high = static_cast<uint64_t>(word >> 64);
+  return high ? count_leading_zeros(high)
+              : 64 + count_leading_zeros(static_cast<uint64_t>(word));
+}
+
+/**
+ *  Returns the number of trailing 0-bits of a nonzero word.
+ **/
+int32_t count_trailing_zeros(uint64_t word) { return __builtin_ctzll(word); }
+
+int32_t count_trailing_zeros(uint128_t word) {
+  const auto low = static_cast<uint64_t>(word);
+  return low ? count_trailing_zeros(low)
+             : 64 + count_trailing_zeros(static_cast<uint64_t>(word >> 64));
+}
+
+/**
+ *  Returns the number of 1-bits of a word.
+ **/
+int32_t count_ones(uint64_t word) { return __builtin_popcountll(word); }
+
+int32_t count_ones(uint128_t word) {
+  return count_ones(static_cast<uint64_t>(word >> 64)) +
+         count_ones(static_cast<uint64_t>(word));
+}
+
+/**
+ *  A sliceable set in a representation chosen by the number of edges, so that
+ *  the core operations compile to a fixed sequence of word operations:
+ *    - Up to 64 edges (n <= 4) a single 64-bit word.
+ *    - Up to 128 edges (n = 5) a single 128-bit word.
+ *    - Otherwise an array of 64-bit words, e.g. 3 words for n = 6.
+ *
+ *  Bit e of the words is edge e like in sliceable_set_t, so comparing packed
+ *  sets compares the bitstring encodings in lexicographic order.
+ **/
+template <int32_t N, typename Enable = void>
+class packed_set {
+ public:
+  static constexpr std::size_t num_words = num_packed_words(N);
+
+  static packed_set from_bitset(const sliceable_set_t<N>& ss) {
+    packed_set packed;
+    for (int32_t e = 0; e < num_edges(N); ++e) {
+      if (ss[e]) {
+        packed.set(e);
+      }
+    }
+    return packed;
+  }
+
+  sliceable_set_t<N> to_bitset() const {
+    sliceable_set_t<N> ss;
+    for_each_edge([&ss](int32_t e) { ss[e] = true; });
+    return ss;
+  }
+
+  bool test(int32_t e) const { return (words_[e / 64] >> (e % 64)) & 1; }
+
+  void set(int32_t e) { words_[e / 64] |= uint64_t{1} << (e % 64); }
+
+  packed_set& operator|=(const packed_set& other) {
+    for (std::size_t w = 0; w < num_words; ++w) {
+      words_[w] |= other.words_[w];
+    }
+    return *this;
+  }
+
+  packed_set operator|(const packed_set& other) const {
+    packed_set result = *this;
+    return result |= other;
+  }
+
+  /**
+   *  Returns true if all edges are in the set and false otherwise.
+   **/
+  bool all() const {
+    uint64_t missing = words_[num_words - 1] ^ top_mask;
+    for (std::size_t w = 0; w + 1 < num_words; ++w) {
+      missing |= ~words_[w];
+    }
+    return missing == 0;
+  }
+
+  int32_t count() const {
+    int32_t count = 0;
+    for (const auto word : words_) {
+      count += count_ones(word);
+    }
+    return count;
+  }
+
+  /**
+   *  Returns the number of leading (leftmost) 0-bits of the bitstring
+   *  encoding.
+   **/
+  int32_t leading_zeros() const {
+    for (std::size_t w = num_words; w-- > 0;) {
+      if (words_[w]) {
+        return count_leading_zeros(words_[w]) - padding_bits +
+               static_cast<int32_t>(64 * (num_words - 1 - w));
+      }
+    }
+    return num_edges(N);
+  }
+
+  /**
+   *  Returns the number of leading (leftmost) 1-bits of the bitstring
+   *  encoding.
+   **/
+  int32_t leading_ones() const {
+    packed_set complement;
+    for (std::size_t w = 0; w < num_words; ++w) {
+      complement.words_[w] = ~words_[w];
+    }
+    complement.words_[num_words - 1] &= top_mask;
+    return complement.leading_zeros();
+  }
+
+  bool operator==(const packed_set& other) const {
+    return words_ == other.words_;
+  }
+
+  bool operator!=(const packed_set& other) const { return !(*this == other); }
+
+  bool operator<(const packed_set& other) const {
+    for (std::size_t w = num_words; w-- > 0;) {
+      if (words_[w] != other.words_[w]) {
+        return words_[w] < other.words_[w];
+      }
+    }
+    return false;
+  }
+
+  /**
+   *  Returns the FNV-1a hash of the words.
+   **/
+  std::size_t hash() const {
+    uint64_t hash = 0xcbf29ce484222325;
+    for (const auto word : words_) {
+      hash = (hash ^ word) * 0x100000001b3;
+    }
+    return static_cast<std::size_t>(hash);
+  }
+
+  /**
+   *  Calls f(e) for every edge e in the set in ascending order.
+   **/
+  template <typename F>
+  void for_each_edge(F f) const {
+    for (std::size_t w = 0; w < num_words; ++w) {
+      for (auto word = words_[w]; word; word &= word - 1) {
+        f(static_cast<int32_t>(64 * w) + count_trailing_zeros(word));
+      }
+    }
+  }
+
+ private:
+  static constexpr int32_t padding_bits =
+      static_cast<int32_t>(64 * num_words) - num_edges(N);
+  static constexpr uint64_t top_mask = ~uint64_t{0} >> padding_bits;
+
+  std::array<uint64_t, num_words> words_ = {};
+};
+
+template <int32_t N>
+class packed_set<N, std::enable_if_t<(num_edges(N) <= 128)>> {
+ public:
+  /* The single word holding all edges. */
+  using word_t =
+      std::conditional_t<(num_edges(N) <= 64), uint64_t, uint128_t>;
+
+  static packed_set from_bitset(const sliceable_set_t<N>& ss) {
+    packed_set packed;
+    for (int32_t e = 0; e < num_edges(N); ++e) {
+      if (ss[e]) {
+        packed.set(e);
+      }
+    }
+    return packed;
+  }
+
+  sliceable_set_t<N> to_bitset() const {
+    sliceable_set_t<N> ss;
+    for_each_edge([&ss](int32_t e) { ss[e] = true; });
+    return ss;
+  }
+
+  bool test(int32_t e) const { return (word_ >> e) & 1; }
+
+  void set(int32_t e) { word_ |= word_t{1} << e; }
+
+  packed_set& operator|=(const packed_set& other) {
+    word_ |= other.word_;
+    return *this;
+  }
+
+  packed_set operator|(const packed_set& other) const {
+    packed_set result = *this;
+    return result |= other;
+  }
+
+  bool all() const { return word_ == mask; }
+
+  int32_t count() const { return count_ones(word_); }
+
+  int32_t leading_zeros() const {
+    return word_ ? count_leading_zeros(word_) - padding_bits : num_edges(N);
+  }
+
+  int32_t leading_ones() const {
+    const word_t complement = ~word_ & mask;
+    return complement ? count_leading_zeros(complement) - padding_bits
+                      : num_edges(N);
+  }
+
+  bool operator==(const packed_set& other) const {
+    return word_ == other.word_;
+  }
+
+  bool operator!=(const packed_set& other) const { return !(*this == other); }
+
+  bool operator<(const packed_set& other) const { return word_ < other.word_; }
+
+  std::size_t hash() const {
+    uint64_t hash = 0xcbf29ce484222325;
+    hash = (hash ^ static_cast<uint64_t>(word_)) * 0x100000001b3;
+    if constexpr (sizeof(word_t) > sizeof(uint64_t)) {
+      hash = (hash ^ static_cast<uint64_t>(word_ >> 64)) * 0x100000001b3;
+    }
+    return static_cast<std::size_t>(hash);
+  }
+
+  template <typename F>
+  void for_each_edge(F f) const {
+    for (auto word = word_; word; word &= word - 1) {
+      f(count_trailing_zeros(word));
+    }
+  }
+
+ private:
+  static constexpr int32_t padding_bits =
+      static_cast<int32_t>(8 * sizeof(word_t)) - num_edges(N);
+  static constexpr word_t mask = ~word_t{0} >> padding_bits;
+
+  word_t word_ = 0;
+};
+
+/**
+ *  Returns the packed representations of a list of sliceable sets in the same
+ *  order.
+ **/
+template <int32_t N>
+std::vector<packed_set<N>> pack_sets(
+    const std::vector<sliceable_set_t<N>>& sets) {
+  std::vector<packed_set<N>> packed;
+  packed.reserve(sets.size());
+  for (const auto& ss : sets) {
+    packed.push_back(packed_set<N>::from_bitset(ss));
+  }
+  return packed;
+}
+
+/**
+ *  Returns the symmetric transformation of a packed set given by permuted
+ *  edges and permuted signs (see transform_edge_int).
+ **/
+template <int32_t N>
+packed_set<N> transform_packed_set(const packed_set<N>& ps,
+                                   const permuted_edges_t<N>& permuted,
+                                   vertex_t permuted_signs) {
+  packed_set<N> ps_trans;
+  ps.for_each_edge([&](int32_t e) {
+    ps_trans.set(transform_edge_int<N>(permuted, e, permuted_signs));
+  });
+  return ps_trans;
+}
+
+/**
+ *  Returns true if any pairwise union of two ranges of packed sets slices all
+ *  edges and false otherwise (see pairwise_unions_slice_cube).
+ *
+ *  The inner loop accumulates without branching on the result and the scan
+ *  returns after the first sliceable set of the first range with a union that
+ *  slices all edges.
+ *
+ *  The second range is required to be sorted in lexicographic order.
+ **/
+template <int32_t N>
+bool pairwise_unions_slice_cube(const packed_set<N>* sets_1_begin,
+                                const packed_set<N>* sets_1_end,
+                                const packed_set<N>* sets_2_begin,
+                                const packed_set<N>* sets_2_end) {
+  for (auto set_1 = sets_1_begin; set_1 != sets_1_end; ++set_1) {
+    const int32_t leading_zeros = set_1->leading_zeros();
+    bool slices_all = false;
+    for (auto set_2 = sets_2_end; set_2 != sets_2_begin;) {
+      --set_2;
+      if (set_2->leading_ones() < leading_zeros) {
+        break;
+      }
+      slices_all |= (*set_1 | *set_2).all();
+    }
+    if (slices_all) {
+      return true;
+    }
+  }
+  return false;
+}
+
+template <int32_t N>
+bool pairwise_unions_slice_cube(const std::vector<packed_set<N>>& sets_1,
+                                const std::vector<packed_set<N>>& sets_2) {
+  return pairwise_unions_slice_cube<N>(sets_1.data(),
+                                       sets_1.data() + sets_1.size(),
+                                       sets_2.data(),
+                                       sets_2.data() + sets_2.size());
+}
+
+}  // namespace ncube
+
+namespace std {
+
+template <int32_t N>
+struct hash<ncube::packed_set<N>> {
+  std::size_t operator()(const ncube::packed_set<N>& ps) const {
+    return ps.hash();
+  }
+};
+
+}  // namespace std
+
+#endif  // N_CUBE_PACKED_SET_H_
@@ -0,0 +1,135 @@
+#ifndef N_CUBE_PAIRWISE_KERNEL_H_
+#define N_CUBE_PAIRWISE_KERNEL_H_
+
+/*
+ *  The pairwise union scan on raw records, usable from C and C++.
+ *
+ *  A padded record stores a sliceable set of the n-cube in 16, 32 or 64 bytes,
+ *  the smallest of these that holds all n * 2^(n - 1) edges. It consists of
+ *  little-endian 64-bit words, where bit e % 64 of word e / 64 is edge e, and
+ *  the bits beyond the last edge are 0. So a record is aligned to its size in
+ *  an aligned buffer, and loading it costs one native load per word on
+ *  little-endian machines.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* The largest padded record has 8 words (64 bytes), enough for n <= 7. */
+#define N_CUBE_PADDED_MAX_WORDS 8
+
+/**
+ *  Returns the number of 64-bit words of a padded record of the n-cube.
+ **/
+static inline size_t padded_record_words(int n) {
+  const size_t num_edges = (size_t)n << (n - 1);
+  size_t num_words = 2;
+  while (64 * num_words < num_edges) {
+    num_words *= 2;
+  }
+  return num_words;
+}
+
+/**
+ *  Returns the number of bytes of a padded record of the n-cube.
+ **/
+static inline size_t padded_record_bytes(int n) {
+  return 8 * padded_record_words(n);
+}
+
+/**
+ *  Returns a little-endian word of a record as a native word.
+ **/
+static inline uint64_t load_padded_word(const uint64_t *word) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  return __builtin_bswap64(*word);
+#else
+  return *word;
+#endif
+}
+
+/**
+ *  The scan of pairwise_unions_slice_cube_padded for a fixed number of words,
+ *  which the compiler unrolls when it is a constant.
+ **/
+static inline __attribute__((always_inline)) int
+pairwise_unions_slice_cube_words(const uint64_t *sets_1, size_t num_sets_1,
+                                 const uint64_t *sets_2, size_t num_sets_2,
+                                 int num_edges, size_t num_words) {
+  /* full[w] are the bits of word w that are edges */
+  uint64_t full[N_CUBE_PADDED_MAX_WORDS];
+  for (size_t w = 0; w < num_words; ++w) {
+    const int bits = num_edges - 64 * (int)w;
+    full[w] = (bits >= 64)  ? ~(uint64_t)0
+              : (bits <= 0) ? 0
+                            : ((uint64_t)1 << bits) - 1;
+  }
+  for (size_t i = 0; i < num_sets_1; ++i) {
+    uint64_t set_1[N_CUBE_PADDED_MAX_WORDS];
+    int top = -1;
+    for (size_t w = 0; w < num_words; ++w) {
+      set_1[w] = load_padded_word(sets_1 + i * num_words + w);
+      if (set_1[w]) {
+        top = 64 * (int)w + 63 - __builtin_clzll(set_1[w]);
+      }
+    }
+    /* The sets of the second list that have at least as many leading 1-bits
+     * as set_1 has leading 0-bits contain all edges above the top edge of
+     * set_1. They form a suffix of the sorted second list. */
+    uint64_t required[N_CUBE_PADDED_MAX_WORDS];
+    for (size_t w = 0; w < num_words; ++w) {
+      const int low = 64 * (int)w;
+      if (top >= low + 63) {
+        required[w] = 0;
+      } else if (top < low) {
+        required[w] = full[w];
+      } else {
+        const uint64_t below = ((uint64_t)2 << (top - low)) - 1;
+        required[w] = full[w] & ~below;
+      }
+    }
+    for (size_t j = num_sets_2; j-- > 0;) {
+      const uint64_t *record_2 = sets_2 + j * num_words;
+      uint64_t missing = 0;
+      uint64_t uncovered = 0;
+      for (size_t w = 0; w < num_words; ++w) {
+        const uint64_t word_2 = load_padded_word(record_2 + w);
+        missing |= required[w] & ~word_2;
+        uncovered |= full[w] & ~(set_1[w] | word_2);
+      }
+      if (missing) {
+        break;
+      }
+      if (!uncovered) {
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
+
+/**
+ *  Returns 1 if any pairwise union of two arrays of padded records of the
+ *  n-cube slices all edges and 0 otherwise (see pairwise_unions_slice_cube).
+ *
+ *  The second array is required to be sorted in lexicographic order.
+ **/
+static inline int pairwise_unions_slice_cube_padded(const uint64_t *sets_1,
+                                                    size_t num_sets_1,
+                                                    const uint64_t *sets_2,
+                                                    size_t num_sets_2, int n) {
+  const int num_edges = n << (n - 1);
+  switch (padded_record_words(n)) {
+    case 2:
+      return pairwise_unions_slice_cube_words(sets_1, num_sets_1, sets_2,
+                                              num_sets_2, num_edges, 2);
+    case 4:
+      return pairwise_unions_slice_cube_words(sets_1, num_sets_1, sets_2,
+                                              num_sets_2, num_edges, 4);
+    default:
+      return pairwise_unions_slice_cube_words(sets_1, num_sets_1, sets_2,
+                                              num_sets_2, num_edges, 8);
+  }
+}
+
+#endif  // N_CUBE_PAIRWISE_KERNEL_H_
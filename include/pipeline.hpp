@@ -0,0 +1,225 @@
+#ifndef N_CUBE_PIPELINE_H_
+#define N_CUBE_PIPELINE_H_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "edge.hpp"
+#include "signature.hpp"
+#include "sliceable_set.hpp"
+#include "thread_pool.hpp"
+
+namespace ncube {
+
+/**
+ *  A blocking queue of bounded capacity connecting the stages of a pipeline.
+ *
+ *  push blocks while the queue is full and pop blocks while it is empty. Once
+ *  the queue is closed, push discards its item and pop returns false as soon
+ *  as the queue is empty.
+ **/
+template <typename T>
+class bounded_queue {
+ public:
+  explicit bounded_queue(std::size_t capacity) : capacity_(capacity) {}
+
+  void push(T item) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_full_.wait(lock,
+                   [this] { return closed_ || items_.size() < capacity_; });
+    if (closed_) {
+      return;
+    }
+    items_.push_back(std::move(item));
+    not_empty_.notify_one();
+  }
+
+  bool pop(T& item) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_empty_.wait(lock, [this] { return closed_ || !items_.empty(); });
+    if (items_.empty()) {
+      return false;
+    }
+    item = std::move(items_.front());
+    items_.pop_front();
+    not_full_.notify_one();
+    return true;
+  }
+
+  void close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    not_full_.notify_all();
+    not_empty_.notify_all();
+  }
+
+ private:
+  std::size_t capacity_;
+  std::deque<T> items_;
+  bool closed_ = false;
+  std::mutex mutex_;
+  std::condition_variable not_full_;
+  std::condition_variable not_empty_;
+};
+
+/**
+ *  A cache of the sliceable sets seen most recently, in a fixed number of
+ *  slots indexed by their hash.
+ *
+ *  A sliceable set is remembered until another sliceable set with the same
+ *  slot is inserted. So the cache finds most duplicates that arrive close
+ *  together, e.g. the representatives of the unions of a set with similar
+ *  sets, in memory that doesn't grow with the number of sets inserted.
+ **/
+template <int32_t N>
+class recent_set_cache {
+ public:
+  explicit recent_set_cache(std::size_t num_slots = 1 << 14)
+      : slots_(num_slots), occupied_(num_slots, false) {}
+
+  /**
+   *  Inserts a sliceable set and returns true if it wasn't in the cache
+   *  before and false otherwise.
+   **/
+  bool insert(const sliceable_set_t<N>& ss) {
+    const auto slot = std::hash<sliceable_set_t<N>>()(ss) % slots_.size();
+    if (occupied_[slot] && slots_[slot] == ss) {
+      return false;
+    }
+    slots_[slot] = ss;
+    occupied_[slot] = true;
+    return true;
+  }
+
+ private:
+  std::vector<sliceable_set_t<N>> slots_;
+  std::vector<bool> occupied_;
+};
+
+/* The number of unions passing through each stage of a fused pipeline. */
+struct pipeline_stats_t {
+  std::atomic<uint64_t> num_unions{0};
+  std::atomic<uint64_t> num_usr{0};
+  std::atomic<uint64_t> num_checked{0};
+};
+
+/**
+ *  Returns true if any union of a sliceable set of each of three lists slices
+ *  all edges and false otherwise.
+ *
+ *  This is the check of pairwise_unions_slice_cube(usr_a, mss_b) for usr_a =
+ *  pairwise_unions(usr_c, mss_d), without materializing usr_a: A generator
+ *  emits the unions of sets_1 and sets_2 in chunks, canonicalizer threads
+ *  compute their unique symmetric representatives and discard the ones they
+ *  have seen recently (see recent_set_cache), and checker threads scan every
+ *  remaining representative against sets_3 as soon as it arrives. The stages
+ *  are connected by bounded queues, so only a few chunks are in flight and
+ *  usr_a is never stored. A duplicate representative that isn't discarded
+ *  only costs a repeated check. All stages stop as soon as a combination
+ *  slicing all edges is found.
+ *
+ *  The scans against sets_3 dominate the cost, so about half of the threads
+ *  besides the generator are checkers.
+ *
+ *  sets_3 has to be closed under all symmetric transformations, so that a
+ *  representative slices the n-cube with a sliceable set of sets_3 if and only
+ *  if the union it represents does.
+ **/
+template <int32_t N>
+bool fused_pairwise_unions_slice_cube(
+    const std::vector<sliceable_set_t<N>>& sets_1,
+    const std::vector<sliceable_set_t<N>>& sets_2,
+    const signature_buckets<N>& sets_3, const edge_lexicon_t<N>& edges,
+    pipeline_stats_t* stats = nullptr) {
+  using chunk_t = std::vector<sliceable_set_t<N>>;
+  constexpr std::size_t chunk_size = 256;
+  auto& pool = default_thread_pool();
+  // the generator takes a participant, the others are split between the
+  // canonicalizers and the checkers
+  const unsigned int num_workers = std::max(pool.size(), 3u) - 1;
+  const unsigned int num_checkers = (num_workers + 1) / 2;
+  const unsigned int num_canonicalizers = num_workers - num_checkers;
+  bounded_queue<chunk_t> unions_queue(4 * num_canonicalizers);
+  bounded_queue<chunk_t> usr_queue(4 * num_checkers);
+  std::atomic<bool> found(false);
+  std::atomic<unsigned int> num_running(num_canonicalizers);
+  const auto generator = [&]() {
+    chunk_t chunk;
+    chunk.reserve(chunk_size);
+    for (const auto& set_1 : sets_1) {
+      for (const auto& set_2 : sets_2) {
+        chunk.push_back(set_1 | set_2);
+        if (chunk.size() == chunk_size) {
+          if (found) {
+            return;
+          }
+          unions_queue.push(std::move(chunk));
+          chunk.clear();
+          chunk.reserve(chunk_size);
+        }
+      }
+    }
+    if (!chunk.empty()) {
+      unions_queue.push(std::move(chunk));
+    }
+  };
+  const auto canonicalizer = [&]() {
+    recent_set_cache<N> seen;
+    chunk_t chunk;
+    while (!found && unions_queue.pop(chunk)) {
+      chunk_t usr_chunk;
+      for (const auto& ss : chunk) {
+        const auto usr = unique_sliceable_set<N>(ss, edges);
+        if (seen.insert(usr)) {
+          usr_chunk.push_back(usr);
+        }
+      }
+      if (stats) {
+        stats->num_unions += chunk.size();
+        stats->num_usr += usr_chunk.size();
+      }
+      if (!usr_chunk.empty()) {
+        usr_queue.push(std::move(usr_chunk));
+      }
+    }
+    if (--num_running == 0) {
+      usr_queue.close();
+    }
+  };
+  const auto checker = [&]() {
+    chunk_t chunk;
+    while (!found && usr_queue.pop(chunk)) {
+      if (stats) {
+        stats->num_checked += chunk.size();
+      }
+      if (pairwise_unions_slice_cube<N>(chunk, sets_3)) {
+        found = true;
+        unions_queue.close();
+        usr_queue.close();
+      }
+    }
+  };
+  // the stages wait for each other
+  pool.run_concurrently(num_workers + 1, [&](unsigned int t) {
+    if (t == 0) {
+      generator();
+      unions_queue.close();
+    } else if (t <= num_checkers) {
+      checker();
+    } else {
+      canonicalizer();
+    }
+  });
+  return found;
+}
+
+}  // namespace ncube
+
+#endif  // N_CUBE_PIPELINE_H_
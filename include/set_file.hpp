@@ -0,0 +1,279 @@
+#ifndef N_CUBE_SET_FILE_H_
+#define N_CUBE_SET_FILE_H_
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "edge.hpp"
+#include "sliceable_set.hpp"
+
+namespace ncube {
+
+/* "NCUBESS" followed by a null byte. */
+constexpr char set_file_magic[8] = {'N', 'C', 'U', 'B', 'E', 'S', 'S', '\0'};
+
+constexpr uint32_t set_file_version = 1;
+
+/* Written in native byte order to detect files from other architectures. */
+constexpr uint32_t set_file_byte_order = 0x01020304;
+
+/* The records start at this offset, which also aligns them to cache lines. */
+constexpr std::size_t set_file_data_offset = 64;
+
+/* Describes the sliceable sets stored in a set file. */
+enum set_file_flags : uint32_t {
+  set_file_sorted = 1 << 0,  // sorted in lexicographic order
+  set_file_usr = 1 << 1,     // unique symmetric representatives
+  set_file_mss = 1 << 2,     // symmetry expansions of maximal sliceable sets
+};
+
+/**
+ *  The header of a set file.
+ *
+ *  A set file stores count records of record_bytes bytes each, beginning at
+ *  data_offset. Every record is the object representation of a
+ *  sliceable_set_t<n>, so a memory mapped set file can be used as an array of
+ *  sliceable sets without any conversion.
+ **/
+struct set_file_header_t {
+  char magic[8];
+  uint32_t version;
+  uint32_t byte_order;
+  uint32_t n;
+  uint32_t record_bytes;
+  uint32_t flags;
+  uint32_t reserved;
+  uint64_t count;
+  uint64_t checksum;
+  uint64_t data_offset;
+  char padding[8];
+};
+
+static_assert(sizeof(set_file_header_t) == set_file_data_offset,
+              "the records have to start right after the header");
+
+/**
+ *  Returns the FNV-1a hash of the 64-bit words of a range of sliceable sets.
+ **/
+template <int32_t N>
+uint64_t set_file_checksum(const sliceable_set_t<N>* begin,
+                           const sliceable_set_t<N>* end,
+                           uint64_t checksum = 0xcbf29ce484222325) {
+  static_assert(sizeof(sliceable_set_t<N>) % sizeof(uint64_t) == 0,
+                "sliceable sets have to consist of 64-bit words");
+  constexpr std::size_t num_words = sizeof(sliceable_set_t<N>) / 8;
+  for (auto it = begin; it != end; ++it) {
+    uint64_t words[num_words];
+    std::memcpy(words, it, sizeof(words));
+    for (const auto word : words) {
+      checksum = (checksum ^ word) * 0x100000001b3;
+    }
+  }
+  return checksum;
+}
+
+/**
+ *  Writes sliceable sets one at a time to a set file at the given path.
+ *
+ *  The header is completed when the writer is closed or destroyed. Opening and
+ *  closing throw if the set file can't be written, so that a set file is never
+ *  silently incomplete; destroying a writer that wasn't closed can't report
+ *  errors.
+ **/
+template <int32_t N>
+class set_file_writer {
+ public:
+  set_file_writer(const std::filesystem::path& path, uint32_t flags)
+      : path_(path), file_(path, std::ios::binary) {
+    if (!file_) {
+      throw std::runtime_error("cannot open set file " + path_.string());
+    }
+    std::memset(&header_, 0, sizeof(header_));
+    std::memcpy(header_.magic, set_file_magic, sizeof(set_file_magic));
+    header_.version = set_file_version;
+    header_.byte_order = set_file_byte_order;
+    header_.n = static_cast<uint32_t>(N);
+    header_.record_bytes = sizeof(sliceable_set_t<N>);
+    header_.flags = flags;
+    header_.checksum = set_file_checksum<N>(nullptr, nullptr);
+    header_.data_offset = set_file_data_offset;
+    file_.write(reinterpret_cast<const char*>(&header_), sizeof(header_));
+  }
+
+  set_file_writer(const set_file_writer&) = delete;
+  set_file_writer& operator=(const set_file_writer&) = delete;
+
+  ~set_file_writer() {
+    try {
+      close();
+    } catch (const std::runtime_error&) {
+    }
+  }
+
+  void write(const sliceable_set_t<N>& ss) {
+    file_.write(reinterpret_cast<const char*>(&ss), sizeof(ss));
+    header_.checksum = set_file_checksum<N>(&ss, &ss + 1, header_.checksum);
+    ++header_.count;
+  }
+
+  void close() {
+    if (file_.is_open()) {
+      file_.seekp(0);
+      file_.write(reinterpret_cast<const char*>(&header_), sizeof(header_));
+      file_.close();
+      if (!file_) {
+        throw std::runtime_error("cannot write set file " + path_.string());
+      }
+    }
+  }
+
+ private:
+  std::filesystem::path path_;
+  std::ofstream file_;
+  set_file_header_t header_;
+};
+
+/**
+ *  Writes sliceable sets to a set file at the given path. Throws if the set
+ *  file can't be written.
+ **/
+template <int32_t N>
+void write_set_file(const std::vector<sliceable_set_t<N>>& sets,
+                    const std::filesystem::path& path, uint32_t flags) {
+  set_file_writer<N> writer(path, flags);
+  for (const auto& ss : sets) {
+    writer.write(ss);
+  }
+  writer.close();
+}
+
+/**
+ *  Returns true if the file at the given path begins with the magic bytes of a
+ *  set file and false otherwise.
+ **/
+bool is_set_file(const std::filesystem::path& path) {
+  char magic[sizeof(set_file_magic)] = {};
+  std::ifstream file(path, std::ios::binary);
+  file.read(magic, sizeof(magic));
+  return file && std::memcmp(magic, set_file_magic, sizeof(magic)) == 0;
+}
+
+/**
+ *  Returns true if a set file with the given header and size in bytes stores
+ *  sliceable sets of the n-cube that can be used in place and false
+ *  otherwise.
+ **/
+template <int32_t N>
+bool is_compatible_set_file(const set_file_header_t& header,
+                            std::size_t file_size) {
+  return std::memcmp(header.magic, set_file_magic, sizeof(set_file_magic)) ==
+             0 &&
+         header.version == set_file_version &&
+         header.byte_order == set_file_byte_order &&
+         header.n == static_cast<uint32_t>(N) &&
+         header.record_bytes == sizeof(sliceable_set_t<N>) &&
+         header.data_offset % alignof(sliceable_set_t<N>) == 0 &&
+         header.data_offset + header.count * header.record_bytes <= file_size;
+}
+
+/**
+ *  A read-only memory mapped view of a set file.
+ *
+ *  The sliceable sets are read directly from the page cache, so opening a set
+ *  file only costs page faults when the sliceable sets are accessed.
+ **/
+template <int32_t N>
+class mapped_set_file {
+ public:
+  explicit mapped_set_file(const std::filesystem::path& path) {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      throw std::runtime_error("cannot open set file " + path.string());
+    }
+    struct stat stat_buf;
+    if (::fstat(fd, &stat_buf) != 0 ||
+        static_cast<std::size_t>(stat_buf.st_size) < sizeof(header_)) {
+      ::close(fd);
+      throw std::runtime_error("cannot read set file " + path.string());
+    }
+    size_ = static_cast<std::size_t>(stat_buf.st_size);
+    addr_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (addr_ == MAP_FAILED) {
+      throw std::runtime_error("cannot map set file " + path.string());
+    }
+    std::memcpy(&header_, addr_, sizeof(header_));
+    if (!is_compatible_set_file<N>(header_, size_)) {
+      ::munmap(addr_, size_);
+      throw std::runtime_error("incompatible set file " + path.string());
+    }
+  }
+
+  mapped_set_file(const mapped_set_file&) = delete;
+  mapped_set_file& operator=(const mapped_set_file&) = delete;
+
+  ~mapped_set_file() { ::munmap(addr_, size_); }
+
+  const sliceable_set_t<N>* begin() const {
+    const auto data = static_cast<const char*>(addr_) + header_.data_offset;
+    return reinterpret_cast<const sliceable_set_t<N>*>(data);
+  }
+
+  const sliceable_set_t<N>* end() const { return begin() + size(); }
+
+  std::size_t size() const { return header_.count; }
+
+  const sliceable_set_t<N>& operator[](std::size_t i) const {
+    return begin()[i];
+  }
+
+  uint32_t flags() const { return header_.flags; }
+
+  /**
+   *  Returns true if the checksum in the header matches the sliceable sets
+   *  and false otherwise. Reads the whole file.
+   **/
+  bool verify_checksum() const {
+    return set_file_checksum<N>(begin(), end()) == header_.checksum;
+  }
+
+  /**
+   *  Returns a copy of all sliceable sets.
+   **/
+  std::vector<sliceable_set_t<N>> to_vector() const {
+    return std::vector<sliceable_set_t<N>>(begin(), end());
+  }
+
+ private:
+  void* addr_ = nullptr;
+  std::size_t size_ = 0;
+  set_file_header_t header_;
+};
+
+/**
+ *  Returns the sliceable sets stored in binary in a file at the given path.
+ *
+ *  Set files are detected by their header, any other file is read as written
+ *  by the function write_to_file.
+ **/
+template <int32_t N>
+std::vector<sliceable_set_t<N>> read_sets(const std::filesystem::path& path) {
+  if (is_set_file(path)) {
+    return mapped_set_file<N>(path).to_vector();
+  }
+  return read_from_file<N>(path);
+}
+
+}  // namespace ncube
+
+#endif  // N_CUBE_SET_FILE_H_
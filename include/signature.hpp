@@ -0,0 +1,270 @@
+#ifndef N_CUBE_SIGNATURE_H_
+#define N_CUBE_SIGNATURE_H_
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "bitset_comparator.hpp"
+#include "edge.hpp"
+#include "sliceable_set.hpp"
+#include "vertex.hpp"
+
+namespace ncube {
+
+/* The number of sliced edges in every direction. The edges in direction i
+ * connect vertices that only differ in the i-th coordinate. */
+template <int32_t N>
+using signature_t = std::array<int32_t, N>;
+
+/* For every direction the edges in that direction. */
+template <int32_t N>
+using direction_masks_t = std::array<sliceable_set_t<N>, N>;
+
+/**
+ *  Returns the edges in every direction.
+ **/
+template <int32_t N>
+direction_masks_t<N> compute_direction_masks(const edge_lexicon_t<N>& edges) {
+  direction_masks_t<N> masks;
+  for (int32_t e = 0; e < num_edges(N); ++e) {
+    masks[get_direction(edges[e])][e] = true;
+  }
+  return masks;
+}
+
+/**
+ *  Returns the signature of a sliceable set.
+ **/
+template <int32_t N>
+signature_t<N> compute_signature(const sliceable_set_t<N>& ss,
+                                 const direction_masks_t<N>& masks) {
+  signature_t<N> signature;
+  for (int32_t i = 0; i < N; ++i) {
+    signature[i] = static_cast<int32_t>((ss & masks[i]).count());
+  }
+  return signature;
+}
+
+/**
+ *  Returns the signature of a sliceable set packed into an integer, so that
+ *  packed signatures compare like signatures. Every direction takes n bits,
+ *  enough for the 2^(n - 1) edges in it.
+ **/
+template <int32_t N>
+uint64_t pack_signature(const sliceable_set_t<N>& ss,
+                        const direction_masks_t<N>& masks) {
+  static_assert(N * N <= 64, "a packed signature has N * N bits");
+  uint64_t key = 0;
+  for (int32_t i = 0; i < N; ++i) {
+    key = (key << N) | (ss & masks[i]).count();
+  }
+  return key;
+}
+
+/**
+ *  Returns the signature packed by pack_signature.
+ **/
+template <int32_t N>
+signature_t<N> unpack_signature(uint64_t key) {
+  signature_t<N> signature;
+  for (int32_t i = N - 1; i >= 0; --i) {
+    signature[i] = static_cast<int32_t>(key & ((uint64_t{1} << N) - 1));
+    key >>= N;
+  }
+  return signature;
+}
+
+/**
+ *  Returns true if the signatures of two sliceable sets allow their union to
+ *  slice all edges in every direction and false otherwise.
+ **/
+template <int32_t N>
+bool signatures_may_slice_cube(const signature_t<N>& x,
+                               const signature_t<N>& y) {
+  // there are 2^(n - 1) edges in every direction
+  for (int32_t i = 0; i < N; ++i) {
+    if (x[i] + y[i] < num_vertices(N - 1)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ *  A list of sliceable sets grouped into buckets of equal signature, which
+ *  are stored consecutively. Every bucket is sorted in lexicographic order.
+ **/
+template <int32_t N>
+class signature_buckets {
+ public:
+  /**
+   *  Groups sliceable sets by signature in place, i.e. in the storage of the
+   *  given vector, and sorts every bucket in lexicographic order.
+   *
+   *  The sliceable sets are swapped into their buckets (as in an American flag
+   *  sort), so apart from the storage of the vector only a few words per
+   *  bucket are needed.
+   **/
+  signature_buckets(std::vector<sliceable_set_t<N>>&& sets,
+                    const edge_lexicon_t<N>& edges)
+      : masks_(compute_direction_masks<N>(edges)), sets_(std::move(sets)) {
+    std::map<uint64_t, std::size_t> counts;
+    for (const auto& ss : sets_) {
+      ++counts[pack_signature<N>(ss, masks_)];
+    }
+    std::vector<uint64_t> keys;
+    keys.reserve(counts.size());
+    bucket_begin_.push_back(0);
+    for (const auto& [key, count] : counts) {
+      keys.push_back(key);
+      signatures_.push_back(unpack_signature<N>(key));
+      bucket_begin_.push_back(bucket_begin_.back() + count);
+    }
+    const auto bucket_of = [&](const sliceable_set_t<N>& ss) {
+      const auto key = pack_signature<N>(ss, masks_);
+      const auto it = std::lower_bound(keys.begin(), keys.end(), key);
+      return static_cast<std::size_t>(it - keys.begin());
+    };
+    // the first position of every bucket that doesn't hold a sliceable set of
+    // the bucket yet
+    std::vector<std::size_t> next(bucket_begin_.begin(),
+                                  bucket_begin_.end() - 1);
+    for (std::size_t b = 0; b < keys.size(); ++b) {
+      while (next[b] < bucket_begin_[b + 1]) {
+        auto& ss = sets_[next[b]];
+        const auto target = bucket_of(ss);
+        if (target == b) {
+          ++next[b];
+        } else {
+          std::swap(ss, sets_[next[target]++]);
+        }
+      }
+      std::sort(sets_.data() + bucket_begin_[b],
+                sets_.data() + bucket_begin_[b + 1]);
+    }
+  }
+
+  /**
+   *  Groups a copy of sliceable sets sorted in lexicographic order by
+   *  signature.
+   **/
+  signature_buckets(const std::vector<sliceable_set_t<N>>& sets,
+                    const edge_lexicon_t<N>& edges)
+      : signature_buckets(std::vector<sliceable_set_t<N>>(sets), edges) {}
+
+  /**
+   *  Moves out the storage of the sliceable sets, e.g. to reuse it, which
+   *  leaves no buckets.
+   **/
+  std::vector<sliceable_set_t<N>> release() {
+    signatures_.clear();
+    bucket_begin_.assign(1, 0);
+    return std::move(sets_);
+  }
+
+  /**
+   *  Returns all sliceable sets, grouped by signature.
+   **/
+  const std::vector<sliceable_set_t<N>>& sets() const { return sets_; }
+
+  std::size_t size() const { return sets_.size(); }
+
+  std::size_t num_buckets() const { return signatures_.size(); }
+
+  const signature_t<N>& signature(std::size_t b) const {
+    return signatures_[b];
+  }
+
+  const sliceable_set_t<N>* bucket_begin(std::size_t b) const {
+    return sets_.data() + bucket_begin_[b];
+  }
+
+  const sliceable_set_t<N>* bucket_end(std::size_t b) const {
+    return sets_.data() + bucket_begin_[b + 1];
+  }
+
+  const direction_masks_t<N>& masks() const { return masks_; }
+
+  /**
+   *  Returns the index of a sliceable set in sets() or -1 if it isn't
+   *  contained.
+   **/
+  int64_t find(const sliceable_set_t<N>& ss) const {
+    const auto signature = compute_signature<N>(ss, masks_);
+    const auto it =
+        std::lower_bound(signatures_.begin(), signatures_.end(), signature);
+    if (it == signatures_.end() || *it != signature) {
+      return -1;
+    }
+    const auto b = static_cast<std::size_t>(it - signatures_.begin());
+    const auto set_it = std::lower_bound(bucket_begin(b), bucket_end(b), ss);
+    if (set_it == bucket_end(b) || *set_it != ss) {
+      return -1;
+    }
+    return set_it - sets_.data();
+  }
+
+ private:
+  direction_masks_t<N> masks_;
+  std::vector<sliceable_set_t<N>> sets_;
+  std::vector<signature_t<N>> signatures_;
+  // the b-th bucket is sets_[bucket_begin_[b]:bucket_begin_[b + 1]]
+  std::vector<std::size_t> bucket_begin_;
+};
+
+/**
+ *  Returns true if any pairwise union of a list of sliceable sets and a list
+ *  of sliceable sets grouped by signature slices all edges and false
+ *  otherwise.
+ *
+ *  Every sliceable set of the first list is only scanned against the buckets
+ *  whose signature may complete its signature, and within a bucket only
+ *  against the sliceable sets with enough leading 1-bits.
+ **/
+template <int32_t N>
+bool pairwise_unions_slice_cube(const sliceable_set_t<N>* sets_1_begin,
+                                const sliceable_set_t<N>* sets_1_end,
+                                const signature_buckets<N>& sets_2) {
+  for (auto it_1 = sets_1_begin; it_1 != sets_1_end; ++it_1) {
+    const auto& set_1 = *it_1;
+    const auto signature_1 = compute_signature<N>(set_1, sets_2.masks());
+    const int32_t leading_zeros = get_leading_zeros<N>(set_1);
+    for (std::size_t b = 0; b < sets_2.num_buckets(); ++b) {
+      if (!signatures_may_slice_cube<N>(signature_1, sets_2.signature(b))) {
+        continue;
+      }
+      const auto bucket_begin = sets_2.bucket_begin(b);
+      for (auto set_2 = sets_2.bucket_end(b); set_2 != bucket_begin;) {
+        --set_2;
+        const int32_t leading_ones = get_leading_ones<N>(*set_2);
+        if (leading_ones < leading_zeros) {
+          break;
+        }
+        if ((set_1 | *set_2).all()) {
+          return true;
+        }
+      }
+    }
+  }
+  return false;
+}
+
+/**
+ *  Returns true if any pairwise union of a list of sliceable sets and a list
+ *  of sliceable sets grouped by signature slices all edges and false
+ *  otherwise.
+ **/
+template <int32_t N>
+bool pairwise_unions_slice_cube(const std::vector<sliceable_set_t<N>>& sets_1,
+                                const signature_buckets<N>& sets_2) {
+  return pairwise_unions_slice_cube<N>(sets_1.data(),
+                                       sets_1.data() + sets_1.size(), sets_2);
+}
+
+}  // namespace ncube
+
+#endif  // N_CUBE_SIGNATURE_H_
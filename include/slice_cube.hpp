@@ -3,13 +3,550 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
 #include <vector>
 
+#include "checkpoint.hpp"
+#include "cover_search.hpp"
 #include "edge.hpp"
+#include "local_search.hpp"
+#include "lower_bound.hpp"
+#include "multithreaded.hpp"
+#include "pipeline.hpp"
+#include "set_file.hpp"
+#include "signature.hpp"
+#include "stabilizer.hpp"
 #include "sliceable_set.hpp"
+#include "stage_arena.hpp"
 
 namespace ncube {
 
+/* How slice_cube_engine decides if k sliceable sets slice the n-cube. */
+enum slice_cube_method {
+  slice_cube_layered,       // pairwise unions of cached stages
+  slice_cube_cover_search,  // depth-first search, see cover_search
+  slice_cube_fused,         // layered, but the last stage is streamed
+};
+
+/**
+ *  Returns the name of a method, as accepted by parse_slice_cube_method.
+ **/
+const char* slice_cube_method_name(slice_cube_method method) {
+  switch (method) {
+    case slice_cube_cover_search:
+      return "cover_search";
+    case slice_cube_fused:
+      return "fused";
+    default:
+      return "layered";
+  }
+}
+
+/**
+ *  Returns the method given by the command line option --method=layered,
+ *  --method=cover_search or --method=fused, or slice_cube_layered if there is
+ *  none.
+ **/
+slice_cube_method parse_slice_cube_method(int argc, char* argv[]) {
+  slice_cube_method method = slice_cube_layered;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strncmp(argv[i], "--method=", 9) != 0) {
+      continue;
+    }
+    const char* name = argv[i] + 9;
+    if (std::strcmp(name, slice_cube_method_name(slice_cube_layered)) == 0) {
+      method = slice_cube_layered;
+    } else if (std::strcmp(name, slice_cube_method_name(
+                                     slice_cube_cover_search)) == 0) {
+      method = slice_cube_cover_search;
+    } else if (std::strcmp(name, slice_cube_method_name(slice_cube_fused)) ==
+               0) {
+      method = slice_cube_fused;
+    } else {
+      throw std::runtime_error(std::string("unknown method ") + name);
+    }
+  }
+  return method;
+}
+
+/* The number of local search steps per thread requested by --upper-bound. */
+constexpr uint64_t default_upper_bound_steps = uint64_t{1} << 20;
+
+/**
+ *  Returns the number of local search steps per thread given by the command
+ *  line option --upper-bound=STEPS, or default_upper_bound_steps for
+ *  --upper-bound, or 0 if there is none, which turns the local search off.
+ **/
+uint64_t parse_upper_bound_steps(int argc, char* argv[]) {
+  uint64_t num_steps = 0;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--upper-bound") == 0) {
+      num_steps = default_upper_bound_steps;
+    } else if (std::strncmp(argv[i], "--upper-bound=", 14) == 0) {
+      num_steps = std::strtoull(argv[i] + 14, nullptr, 10);
+    }
+  }
+  return num_steps;
+}
+
+/**
+ *  Decides for any k if a combination of k sliceable sets given by their unique
+ *  symmetric representatives slices the n-cube.
+ *
+ *  The engine caches the stages usr_i, the unique symmetric representatives of
+ *  the unions of i sliceable sets, and mss_i, their symmetry expansions. k
+ *  sliceable sets slice the n-cube if and only if the pairwise unions of usr_a
+ *  and mss_b slice it for any split k = a + b, and usr_i is computed from
+ *  usr_c and mss_d for any split i = c + d. Every split is chosen by the
+ *  estimated cost of the stages that still have to be computed and of the
+ *  pairwise unions, where the size of an uncomputed stage is estimated from
+ *  the stages it is computed from. The unions of usr_c and mss_d skip the
+ *  partners that are equivalent under the stabilizer of a set of usr_c (see
+ *  stabilizer_filter). The pairwise unions of usr_a and mss_b are scanned in
+ *  parallel on the default thread pool. Every mss_i is grouped by signature
+ *  in the buffer it is expanded into, which is taken from the shared stage
+ *  arena and returned to it when the engine is destroyed.
+ *
+ *  With slice_cube_fused, a scan whose usr_a isn't cached streams the unions
+ *  of usr_c and mss_d for a = c + d into the scan instead (see
+ *  fused_pairwise_unions_slice_cube), so usr_a is never stored. Alternatively,
+ *  the engine decides every k by a depth-first search over the symmetry
+ *  expansions of usr_1, which needs no stages at all.
+ *
+ *  Before deciding k, the engine checks the lower bounds given by the largest
+ *  cached unions (see union_lower_bound) and skips every k below them.
+ *
+ *  An upper bound on k found by local search (see find_upper_bound) ends the
+ *  search for k at the upper bound, which needs no stages.
+ *
+ *  If checkpointing is on (see configure_checkpoints), every computed stage
+ *  usr_i is saved to a set file, and every layered scan keeps its progress in
+ *  a scan checkpoint. Resuming restores the saved stages
+ *  instead of computing them and continues the scans where they stopped. The
+ *  checkpoints are kept in a directory per usr_1, so checkpoints of different
+ *  engines don't mix. The stages mss_i aren't saved, as expanding usr_i is
+ *  cheap compared to computing it.
+ *
+ *  Every computed stage, every decisive bound and the witness of a decisive
+ *  upper bound are reported to the log, if any.
+ **/
+template <int32_t N>
+class slice_cube_engine {
+ public:
+  slice_cube_engine(const std::vector<sliceable_set_t<N>>& usr_1,
+                    const edge_lexicon_t<N>& edges,
+                    slice_cube_method method = slice_cube_layered,
+                    std::ostream* log = nullptr)
+      : edges_(edges),
+        method_(method),
+        log_(log),
+        arena_(default_stage_arena<N>()),
+        checkpoints_(default_checkpoint_options()) {
+    usr_[1] = usr_1;
+    max_sliced_[1] = max_sliced_edges<N>(usr_1);
+    if (!checkpoints_.dir.empty()) {
+      const auto fingerprint = set_file_checksum<N>(
+          usr_1.data(), usr_1.data() + usr_1.size());
+      checkpoint_dir_ = checkpoints_.dir / ("engine_" + std::to_string(N) +
+                                            "_" + std::to_string(fingerprint));
+      std::filesystem::create_directories(checkpoint_dir_);
+    }
+  }
+
+  /**
+   *  Releases the buffers of the mss stages to the arena, so that the next
+   *  engine reuses them.
+   **/
+  ~slice_cube_engine() {
+    for (auto& [i, mss_i] : mss_) {
+      arena_.release(mss_i.release());
+    }
+  }
+
+  /**
+   *  Returns the unique symmetric representatives of the unions of i sliceable
+   *  sets. Eliminates non-maximal unions on a best effort basis.
+   **/
+  const std::vector<sliceable_set_t<N>>& usr(int32_t i) {
+    const auto it = usr_.find(i);
+    if (it != usr_.end()) {
+      return it->second;
+    }
+    if (restore_usr(i)) {
+      return usr_.at(i);
+    }
+    const auto [c, d] = best_split(i, false);
+    const auto& usr_c = usr(c);
+    mss(d);
+    auto& usr_i = usr_[i];
+    usr_i = pairwise_unions<N>(usr_c, mss_.at(d), edges_);
+    max_sliced_[i] = max_sliced_edges<N>(usr_i);
+    estimates_.clear();
+    if (log_) {
+      *log_ << "  usr_" << i << " = pairwise_unions(usr_" << c << ", mss_" << d
+            << "): " << usr_i.size() << " sets" << std::endl;
+    }
+    if (!checkpoint_dir_.empty()) {
+      write_set_file_checkpoint<N>(usr_i, usr_path(i), set_file_usr);
+    }
+    return usr_i;
+  }
+
+  /**
+   *  Returns the symmetry expansions of usr(i), grouped by signature (see
+   *  signature_buckets).
+   **/
+  const std::vector<sliceable_set_t<N>>& mss(int32_t i) {
+    const auto it = mss_.find(i);
+    if (it != mss_.end()) {
+      return it->second.sets();
+    }
+    const auto& usr_i = usr(i);
+    const auto num_expansions =
+        usr_i.size() * static_cast<std::size_t>(num_transformations(N));
+    auto expansions = arena_.acquire(num_expansions);
+    expand_usr<N>(usr_i, edges_, expansions);
+    // the expansions are grouped in their own buffer
+    const auto& mss_i =
+        mss_.emplace(i, signature_buckets<N>(std::move(expansions), edges_))
+            .first->second;
+    estimates_.clear();
+    if (log_) {
+      *log_ << "  mss_" << i << " = expand_usr(usr_" << i
+            << "): " << mss_i.size() << " sets in " << mss_i.num_buckets()
+            << " signatures (arena: " << arena_.num_allocated()
+            << " allocated, " << arena_.num_reused() << " reused)"
+            << std::endl;
+    }
+    return mss_i.sets();
+  }
+
+  /**
+   *  Returns true if a combination of k sliceable sets slices the n-cube and
+   *  false otherwise.
+   **/
+  bool slices_cube(int32_t k) {
+    if (k == 1) {
+      const auto all = [](const sliceable_set_t<N>& ss) { return ss.all(); };
+      return std::any_of(usr_[1].begin(), usr_[1].end(), all);
+    }
+    if (method_ == slice_cube_cover_search) {
+      if (!cover_search_) {
+        cover_search_.emplace(usr_[1], edges_);
+      }
+      if (log_) {
+        *log_ << "  k = " << k << ": cover_search(usr_1)" << std::endl;
+      }
+      return cover_search_->slices_cube(k);
+    }
+    const auto [a, b] = best_split(k, true);
+    if (method_ == slice_cube_fused && a > 1 && !usr_.count(a)) {
+      const auto [c, d] = best_split(a, false);
+      const auto& usr_c = usr(c);
+      const auto& mss_d = mss(d);
+      mss(b);
+      if (log_) {
+        *log_ << "  k = " << k << ": fused_pairwise_unions_slice_cube(usr_"
+              << c << ", mss_" << d << ", mss_" << b << ")" << std::endl;
+      }
+      return fused_pairwise_unions_slice_cube<N>(usr_c, mss_d, mss_.at(b),
+                                                 edges_);
+    }
+    const auto& usr_a = usr(a);
+    mss(b);
+    const auto& mss_b = mss_.at(b);
+    if (log_) {
+      *log_ << "  k = " << k << ": pairwise_unions_slice_cube(usr_" << a
+            << ", mss_" << b << ")" << std::endl;
+    }
+    if (!checkpoint_dir_.empty()) {
+      return pairwise_unions_slice_cube_checkpointed(a, b);
+    }
+    return pairwise_unions_slice_cube_parallel<N>(usr_a, mss_b);
+  }
+
+  /**
+   *  Returns the smallest k so that a combination of k sliceable sets slices
+   *  the n-cube. If k is larger than the specified maximum, -1 is returned
+   *  instead.
+   **/
+  int32_t min(int32_t max) {
+    for (int32_t k = 1; k <= max; ++k) {
+      const auto [bound, j] = lower_bound();
+      if (k < bound) {
+        if (log_) {
+          *log_ << "  k >= " << bound << ": unions of " << j
+                << " sliceable sets slice at most " << max_sliced_[j] << " of "
+                << num_edges(N) << " edges" << std::endl;
+        }
+        k = bound - 1;
+        continue;
+      }
+      if (upper_bound_ > 0 && k >= upper_bound_) {
+        if (log_) {
+          *log_ << "  k = " << k << ": witness found by local search"
+                << std::endl;
+          for (const auto& ss : witness_) {
+            *log_ << "    " << ss << std::endl;
+          }
+        }
+        return k;
+      }
+      if (slices_cube(k)) {
+        // then no smaller k had to be scanned
+        if (log_ && k > 1 && k == bound) {
+          *log_ << "  k = " << k << ": the lower bound of the unions of " << j
+                << " sliceable sets is attained" << std::endl;
+        }
+        return k;
+      }
+    }
+    return -1;
+  }
+
+  /**
+   *  Searches for a combination of few sliceable sets that slices the n-cube
+   *  and returns their number, or -1 if there is none. Starts from a greedy
+   *  combination and repeatedly looks for a combination of one sliceable set
+   *  less by local_search_cover with num_steps steps per thread, until it
+   *  fails or reaches the lower bound.
+   **/
+  int32_t find_upper_bound(uint64_t num_steps) {
+    const auto& mss_1 = mss(1);
+    if (upper_bound_ < 0) {
+      witness_ = greedy_cover<N>(mss_1);
+      if (witness_.empty()) {
+        return -1;
+      }
+      upper_bound_ = static_cast<int32_t>(witness_.size());
+      if (log_) {
+        *log_ << "  k <= " << upper_bound_ << ": greedy_cover(mss_1)"
+              << std::endl;
+      }
+    }
+    while (upper_bound_ > lower_bound().first) {
+      auto cover = local_search_cover<N>(mss_1, upper_bound_ - 1, num_steps);
+      if (cover.empty()) {
+        break;
+      }
+      witness_ = std::move(cover);
+      --upper_bound_;
+      if (log_) {
+        *log_ << "  k <= " << upper_bound_ << ": local_search_cover(mss_1)"
+              << std::endl;
+      }
+    }
+    return upper_bound_;
+  }
+
+  /**
+   *  Returns the combination of sliceable sets found by find_upper_bound.
+   **/
+  const std::vector<sliceable_set_t<N>>& witness() const { return witness_; }
+
+ private:
+  /**
+   *  Returns the path of the saved stage usr_i.
+   **/
+  std::filesystem::path usr_path(int32_t i) const {
+    return checkpoint_dir_ / ("usr_" + std::to_string(i) + ".nss");
+  }
+
+  /**
+   *  Restores the stage usr_i from its set file when resuming. Returns true
+   *  if it was restored and false otherwise.
+   **/
+  bool restore_usr(int32_t i) {
+    if (checkpoint_dir_.empty() || !checkpoints_.resume ||
+        !std::filesystem::exists(usr_path(i))) {
+      return false;
+    }
+    const mapped_set_file<N> file(usr_path(i));
+    if (!file.verify_checksum()) {
+      throw std::runtime_error("corrupt checkpoint " + usr_path(i).string());
+    }
+    auto& usr_i = usr_[i];
+    usr_i = file.to_vector();
+    max_sliced_[i] = max_sliced_edges<N>(usr_i);
+    estimates_.clear();
+    if (log_) {
+      *log_ << "  usr_" << i << " = restored from " << usr_path(i) << ": "
+            << usr_i.size() << " sets" << std::endl;
+    }
+    return true;
+  }
+
+  /**
+   *  Returns true if any pairwise union of the cached stages usr_a and mss_b
+   *  slices the n-cube and false otherwise, like pairwise_unions_slice_cube,
+   *  but scans in parallel and keeps the progress in a scan checkpoint.
+   **/
+  bool pairwise_unions_slice_cube_checkpointed(int32_t a, int32_t b) {
+    const auto& usr_a = usr_.at(a);
+    const auto& mss_b = mss_.at(b);
+    const auto& sets_b = mss_b.sets();
+    const auto fingerprint =
+        scan_fingerprint<N>(usr_a.data(), usr_a.data() + usr_a.size(),
+                            sets_b.data(), sets_b.data() + sets_b.size());
+    const auto path = checkpoint_dir_ / ("scan_usr_" + std::to_string(a) +
+                                         "_mss_" + std::to_string(b));
+    scan_checkpoint checkpoint(path, fingerprint, checkpoints_.resume,
+                               checkpoints_.flush_seconds);
+    if (log_ && checkpoint.num_completed() > 0) {
+      *log_ << "  resumed after " << checkpoint.num_completed() << " of "
+            << usr_a.size() << " sets of usr_" << a << std::endl;
+    }
+    const auto scan = [&](std::size_t begin, std::size_t end) {
+      return pairwise_unions_slice_cube<N>(usr_a.data() + begin,
+                                           usr_a.data() + end, mss_b);
+    };
+    return scan_checkpointed(usr_a.size(), checkpoint, scan);
+  }
+
+  /**
+   *  Returns the best lower bound on k given by the cached stages usr_j and
+   *  the j it is given by.
+   **/
+  std::pair<int32_t, int32_t> lower_bound() const {
+    std::pair<int32_t, int32_t> best(1, 1);
+    for (const auto& [j, max_sliced] : max_sliced_) {
+      const int32_t bound = union_lower_bound<N>(j, max_sliced);
+      if (bound > best.first) {
+        best = {bound, j};
+      }
+    }
+    return best;
+  }
+
+  /**
+   *  Returns the split i = a + b with the smallest estimated cost of computing
+   *  the pairwise unions of usr_a and mss_b, including the stages that aren't
+   *  cached. If scan is true, the pairwise unions are only checked for slicing
+   *  the n-cube, otherwise their unique symmetric representatives are
+   *  computed.
+   **/
+  std::pair<int32_t, int32_t> best_split(int32_t i, bool scan) {
+    std::pair<int32_t, int32_t> best(i - i / 2, i / 2);
+    double best_cost = -1;
+    for (int32_t b = 1; b < i; ++b) {
+      const int32_t a = i - b;
+      const double pairs = estimated_size(a, false) * estimated_size(b, true);
+      // computing a unique symmetric representative visits all
+      // transformations
+      const double pair_cost = scan ? pairs : pairs * num_transformations(N);
+      const double cost =
+          estimated_cost(a, false) + estimated_cost(b, true) + pair_cost;
+      if (best_cost < 0 || cost < best_cost) {
+        best = {a, b};
+        best_cost = cost;
+      }
+    }
+    return best;
+  }
+
+  /**
+   *  Returns the size of a cached stage or -1 if it isn't cached.
+   **/
+  double cached_size(int32_t i, bool is_mss) const {
+    if (is_mss) {
+      const auto it = mss_.find(i);
+      return (it != mss_.end()) ? static_cast<double>(it->second.size()) : -1;
+    }
+    const auto it = usr_.find(i);
+    return (it != usr_.end()) ? static_cast<double>(it->second.size()) : -1;
+  }
+
+  /**
+   *  Returns the size of a cached stage or else an estimate: usr_i is assumed
+   *  to contain one set per orbit of the pairwise unions it is computed from
+   *  and mss_i to contain the full orbits of usr_i.
+   **/
+  double estimated_size(int32_t i, bool is_mss) {
+    const double size_cached = cached_size(i, is_mss);
+    if (size_cached >= 0) {
+      return size_cached;
+    }
+    const auto key = std::make_tuple(i, is_mss, false);
+    const auto memo = estimates_.find(key);
+    if (memo != estimates_.end()) {
+      return memo->second;
+    }
+    double size = -1;
+    if (is_mss) {
+      size = estimated_size(i, false) * num_transformations(N);
+    }
+    for (int32_t d = 1; d < i && !is_mss; ++d) {
+      const double pairs =
+          estimated_size(i - d, false) * estimated_size(d, true);
+      const double size_d = std::max(pairs / num_transformations(N), 1.0);
+      if (size < 0 || size_d < size) {
+        size = size_d;
+      }
+    }
+    estimates_[key] = size;
+    return size;
+  }
+
+  /**
+   *  Returns zero for a cached stage or else the estimated cost of computing
+   *  it.
+   **/
+  double estimated_cost(int32_t i, bool is_mss) {
+    if (cached_size(i, is_mss) >= 0) {
+      return 0;
+    }
+    const auto key = std::make_tuple(i, is_mss, true);
+    const auto memo = estimates_.find(key);
+    if (memo != estimates_.end()) {
+      return memo->second;
+    }
+    double cost = -1;
+    if (is_mss) {
+      cost = estimated_cost(i, false) +
+             estimated_size(i, false) * num_transformations(N);
+    }
+    for (int32_t d = 1; d < i && !is_mss; ++d) {
+      const double pairs =
+          estimated_size(i - d, false) * estimated_size(d, true);
+      const double cost_d = estimated_cost(i - d, false) +
+                            estimated_cost(d, true) +
+                            pairs * num_transformations(N);
+      if (cost < 0 || cost_d < cost) {
+        cost = cost_d;
+      }
+    }
+    estimates_[key] = cost;
+    return cost;
+  }
+
+  const edge_lexicon_t<N>& edges_;
+  slice_cube_method method_;
+  std::ostream* log_;
+  std::map<int32_t, std::vector<sliceable_set_t<N>>> usr_;
+  std::map<int32_t, signature_buckets<N>> mss_;
+  // the largest number of edges sliced by a set of usr_j by j
+  std::map<int32_t, int32_t> max_sliced_;
+  // estimated sizes and costs of uncached stages by (i, is_mss, is_cost)
+  std::map<std::tuple<int32_t, bool, bool>, double> estimates_;
+  // recycles the buffers of the mss stages between engines
+  stage_arena<N>& arena_;
+  std::optional<cover_search<N>> cover_search_;
+  int32_t upper_bound_ = -1;
+  std::vector<sliceable_set_t<N>> witness_;
+  checkpoint_options_t checkpoints_;
+  // the directory of the checkpoints of this engine, empty if there are none
+  std::filesystem::path checkpoint_dir_;
+};
+
 /**
  *  Returns the smallest k so that a combination of k sliceable sets given by
  *  their unique symmetric representatives slices the n-cube.
@@ -17,59 +554,41 @@ namespace ncube {
  *  If k is larger than the specified maximum, the function terminates
  *  prematurely and returns -1.
  *
- *  Not implemented for maxima larger than 7.
+ *  If upper_bound_steps is positive, an upper bound on k is searched for
+ *  first (see slice_cube_engine::find_upper_bound), which ends the search at
+ *  the upper bound.
+ *
+ *  Every computed stage and every decisive bound is reported to the log, if
+ *  any (see slice_cube_engine).
  */
 template <int32_t N>
 int32_t slice_cube_min(const std::vector<sliceable_set_t<N>>& usr_1,
-                       int32_t max, const edge_lexicon_t<N>& edges) {
-  if (max < 1) return -1;
-  const auto all = [](const sliceable_set_t<N>& ss) { return ss.all(); };
-  if (std::any_of(usr_1.begin(), usr_1.end(), all)) {
-    return 1;
-  }
-  if (max == 1) return -1;
-  const auto mss_1 = expand_usr<N>(usr_1, edges);
-  if (pairwise_unions_slice_cube<N>(usr_1, mss_1)) {
-    return 2;
-  }
-  if (max == 2) return -1;
-  const auto usr_2 = pairwise_unions<N>(usr_1, mss_1, edges);
-  if (pairwise_unions_slice_cube<N>(usr_2, mss_1)) {
-    return 3;
-  }
-  if (max == 3) return -1;
-  const auto mss_2 = expand_usr<N>(usr_2, edges);
-  if (pairwise_unions_slice_cube<N>(usr_2, mss_2)) {
-    return 4;
-  }
-  if (max == 4) return -1;
-  const auto usr_3 = pairwise_unions<N>(usr_2, mss_1, edges);
-  if (pairwise_unions_slice_cube<N>(usr_3, mss_2)) {
-    return 5;
-  }
-  if (max == 5) return -1;
-  const auto mss_3 = expand_usr<N>(usr_3, edges);
-  if (pairwise_unions_slice_cube<N>(usr_3, mss_3)) {
-    return 6;
-  }
-  if (max == 6) return -1;
-  const auto usr_4 = pairwise_unions<N>(usr_2, mss_2, edges);
-  if (pairwise_unions_slice_cube<N>(usr_4, mss_3)) {
-    return 7;
-  }
-  return -1;
+                       int32_t max, const edge_lexicon_t<N>& edges,
+                       slice_cube_method method = slice_cube_layered,
+                       std::ostream* log = nullptr,
+                       uint64_t upper_bound_steps = 0) {
+  slice_cube_engine<N> engine(usr_1, edges, method, log);
+  if (upper_bound_steps > 0) {
+    engine.find_upper_bound(upper_bound_steps);
+  }
+  return engine.min(max);
 }
 
 /**
  *  Returns the smallest k so that a combination of k sliceable sets given by
  *  their unique symmetric representatives slices the n-cube.
  *
- *  If k is larger than 7, -1 is returned instead.
+ *  As every edge is sliced by some sliceable set, k is at most the number of
+ *  edges.
  */
 template <int32_t N>
 int32_t slice_cube_min(const std::vector<sliceable_set_t<N>>& usr_1,
-                       const edge_lexicon_t<N>& edges) {
-  return slice_cube_min<N>(usr_1, 7, edges);
+                       const edge_lexicon_t<N>& edges,
+                       slice_cube_method method = slice_cube_layered,
+                       std::ostream* log = nullptr,
+                       uint64_t upper_bound_steps = 0) {
+  return slice_cube_min<N>(usr_1, num_edges(N), edges, method, log,
+                           upper_bound_steps);
 }
 
 }  // namespace ncube
@@ -5,12 +5,15 @@
 #include <array>
 #include <bitset>
 #include <cstdint>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <vector>
 
+#include "bit_sliced.hpp"
 #include "bitset_comparator.hpp"
 #include "edge.hpp"
+#include "pairwise_kernel.h"
 #include "vertex.hpp"
 
 namespace ncube {
@@ -35,28 +38,30 @@ template <int32_t N>
 using sliceable_set_bytes_t =
     std::array<char, min_bytes_to_represent_bits(num_edges(N))>;
 
+/* The number of symmetric transformations of the n-cube is n! * 2^n. */
+constexpr double num_transformations(int32_t n) {
+  return (n <= 1) ? 2.0 : 2.0 * n * num_transformations(n - 1);
+}
+
 /**
  *  Returns the unique symmetric representative of a sliceable set.
  **/
 template <int32_t N>
 sliceable_set_t<N> unique_sliceable_set(const sliceable_set_t<N>& ss,
                                         const edge_lexicon_t<N>& edges) {
-  std::array<int32_t, N> permutation;
-  for (int32_t i = 0; i < N; ++i) {
-    permutation[i] = i;
-  }
   // Since the unique symmetric representative of a sliceable set is defined as
   // the lexicographically smallest transformation, a transformation may be
   // aborted as soon as any resulting bit (starting from the leftmost bit) is 1
   // and the corresponding bit of the current minimum is 0.
   sliceable_set_t<N> min_ss = ss;
-  do {
+  for (const auto& permutation : permutations<N>) {
+    const auto permuted = permute_edges<N>(permutation, edges);
     for (int32_t signs = 0; signs < num_vertices(N); ++signs) {
+      const auto permuted_signs = transform_vertex<N>(signs, permutation, 0);
       sliceable_set_t<N> ss_trans;
       bool is_new_min = false;
       for (int32_t e = num_edges(N) - 1; e >= 0; --e) {
-        const auto edge_trans = transform_edge<N>(edges[e], permutation, signs);
-        const auto e_trans = edge_to_int<N>(edge_trans, edges);
+        const auto e_trans = transform_edge_int<N>(permuted, e, permuted_signs);
         // This actually computes the inverse transformation, but because the
         // algorithm goes through all transformations it ultimately ends up
         // being the same.
@@ -70,10 +75,63 @@ sliceable_set_t<N> unique_sliceable_set(const sliceable_set_t<N>& ss,
         min_ss = ss_trans;
       }
     }
-  } while (std::next_permutation(permutation.begin(), permutation.end()));
+  }
   return min_ss;
 }
 
+/**
+ *  Calls f(ss_trans) for every symmetric transformation ss_trans of a sliceable
+ *  set. Transformations that are equal are passed to f repeatedly.
+ **/
+template <int32_t N, typename F>
+void for_each_transformation(const sliceable_set_t<N>& ss,
+                             const edge_lexicon_t<N>& edges, F f) {
+  std::vector<int32_t> ss_edges;
+  for (int32_t e = 0; e < num_edges(N); ++e) {
+    if (ss[e]) {
+      ss_edges.push_back(e);
+    }
+  }
+  for (const auto& permutation : permutations<N>) {
+    const auto permuted = permute_edges<N>(permutation, edges);
+    for (int32_t signs = 0; signs < num_vertices(N); ++signs) {
+      const auto permuted_signs = transform_vertex<N>(signs, permutation, 0);
+      sliceable_set_t<N> ss_trans;
+      for (const auto e : ss_edges) {
+        ss_trans[transform_edge_int<N>(permuted, e, permuted_signs)] = true;
+      }
+      f(ss_trans);
+    }
+  }
+}
+
+/**
+ *  Stores the symmetry expansions of the unique symmetric representatives of
+ *  sliceable sets in a buffer, replacing its contents. The buffer is reserved
+ *  for all transformations up front, so a buffer of sufficient capacity is
+ *  reused without reallocation.
+ *
+ *  The stored sliceable sets are sorted in lexicographic order.
+ **/
+template <int32_t N>
+void expand_usr(const std::vector<sliceable_set_t<N>>& usr,
+                const edge_lexicon_t<N>& edges,
+                std::vector<sliceable_set_t<N>>& expansions) {
+  // every orbit has at most one set per transformation
+  expansions.clear();
+  expansions.reserve(usr.size() *
+                     static_cast<std::size_t>(num_transformations(N)));
+  const auto add = [&expansions](const sliceable_set_t<N>& ss_trans) {
+    expansions.push_back(ss_trans);
+  };
+  for (const auto& ss : usr) {
+    for_each_transformation<N>(ss, edges, add);
+  }
+  std::sort(expansions.begin(), expansions.end());
+  expansions.erase(std::unique(expansions.begin(), expansions.end()),
+                   expansions.end());
+}
+
 /**
  *  Returns the symmetry expansions of the unique symmetric representatives of
  *  sliceable sets.
@@ -85,27 +143,7 @@ std::vector<sliceable_set_t<N>> expand_usr(
     const std::vector<sliceable_set_t<N>>& usr,
     const edge_lexicon_t<N>& edges) {
   std::vector<sliceable_set_t<N>> expansions;
-  for (const auto& ss : usr) {
-    std::array<int32_t, N> permutation;
-    for (int32_t i = 0; i < N; ++i) {
-      permutation[i] = i;
-    }
-    do {
-      for (int32_t signs = 0; signs < num_vertices(N); ++signs) {
-        sliceable_set_t<N> ss_trans;
-        for (int32_t e = 0; e < num_edges(N); ++e) {
-          const auto edge_trans =
-              transform_edge<N>(edges[e], permutation, signs);
-          const auto e_trans = edge_to_int<N>(edge_trans, edges);
-          ss_trans[e_trans] = ss[e];
-        }
-        expansions.push_back(ss_trans);
-      }
-    } while (std::next_permutation(permutation.begin(), permutation.end()));
-  }
-  std::sort(expansions.begin(), expansions.end());
-  expansions.erase(std::unique(expansions.begin(), expansions.end()),
-                   expansions.end());
+  expand_usr<N>(usr, edges, expansions);
   return expansions;
 }
 
@@ -132,29 +170,56 @@ std::vector<sliceable_set_t<N>> reduce_to_usr(
 /**
  *  Returns the maximal sliceable sets among the given sliceable sets.
  *
+ *  The sliceable sets are processed from the largest to the smallest and
+ *  tested against the kept sliceable sets in bit-sliced batches (see
+ *  bit_sliced_family).
+ *
  *  The returned sliceable sets are sorted in lexicographic order.
  **/
 template <int32_t N>
 std::vector<sliceable_set_t<N>> reduce_to_mss(
     const std::vector<sliceable_set_t<N>>& sets) {
-  std::vector<sliceable_set_t<N>> mss;
-  for (const auto& curr : sets) {
-    const auto is_superset_of_curr = [curr](const sliceable_set_t<N>& ss) {
-      return (curr | ss) == ss;
-    };
-    if (std::none_of(mss.begin(), mss.end(), is_superset_of_curr)) {
-      const auto is_subset_of_curr = [curr](const sliceable_set_t<N>& ss) {
-        return (curr | ss) == curr;
-      };
-      const auto it = std::remove_if(mss.begin(), mss.end(), is_subset_of_curr);
-      mss.erase(it, mss.end());
-      mss.push_back(curr);
+  // a sliceable set can only be a subset of sliceable sets that are at least
+  // as large, so none of the kept sliceable sets is ever removed
+  std::vector<std::pair<std::size_t, const sliceable_set_t<N>*>> order;
+  order.reserve(sets.size());
+  for (const auto& ss : sets) {
+    order.emplace_back(ss.count(), &ss);
+  }
+  const auto by_count = [](const auto& x, const auto& y) {
+    return x.first > y.first;
+  };
+  std::stable_sort(order.begin(), order.end(), by_count);
+  bit_sliced_family<num_edges(N)> family;
+  for (const auto& [count, ss] : order) {
+    if (!family.any_superset_of(*ss)) {
+      family.add(*ss);
     }
   }
+  auto mss = family.sets();
   std::sort(mss.begin(), mss.end());
   return mss;
 }
 
+/**
+ *  Returns unique symmetric representatives of unions collected by
+ *  bit_sliced_family::add_maximal sorted in lexicographic order. Small lists
+ *  are reduced to the representatives of the maximal unions.
+ **/
+template <int32_t N>
+std::vector<sliceable_set_t<N>> finish_pairwise_unions(
+    std::vector<sliceable_set_t<N>> unions, const edge_lexicon_t<N>& edges) {
+  // Eliminating all non-maximal unions has quadratic running time
+  if (unions.size() < 1000) {
+    unions = expand_usr<N>(unions, edges);
+    unions = reduce_to_mss<N>(unions);
+    unions = reduce_to_usr<N>(unions, edges);
+  } else {
+    std::sort(unions.begin(), unions.end());
+  }
+  return unions;
+}
+
 /**
  *  Returns the unique symmetric representatives of the pairwise unions of two
  *  lists of sliceable sets. Eliminates non-maximal unions on a best effort
@@ -167,33 +232,14 @@ std::vector<sliceable_set_t<N>> pairwise_unions(
     const std::vector<sliceable_set_t<N>>& sets_1,
     const std::vector<sliceable_set_t<N>>& sets_2,
     const edge_lexicon_t<N>& edges) {
-  std::vector<sliceable_set_t<N>> unions;
+  bit_sliced_family<num_edges(N)> unions;
   for (const auto& set_1 : sets_1) {
     for (const auto& set_2 : sets_2) {
       const auto usr = unique_sliceable_set<N>(set_1 | set_2, edges);
-      const auto is_superset_of_usr = [usr](const sliceable_set_t<N>& ss) {
-        return (usr | ss) == ss;
-      };
-      if (std::none_of(unions.begin(), unions.end(), is_superset_of_usr)) {
-        const auto is_subset_of_usr = [usr](const sliceable_set_t<N>& ss) {
-          return (usr | ss) == usr;
-        };
-        const auto it =
-            std::remove_if(unions.begin(), unions.end(), is_subset_of_usr);
-        unions.erase(it, unions.end());
-        unions.push_back(usr);
-      }
+      unions.add_maximal(usr);
     }
   }
-  // Eliminating all non-maximal unions has quadratic running time
-  if (unions.size() < 1000) {
-    unions = expand_usr<N>(unions, edges);
-    unions = reduce_to_mss<N>(unions);
-    unions = reduce_to_usr<N>(unions, edges);
-  } else {
-    std::sort(unions.begin(), unions.end());
-  }
-  return unions;
+  return finish_pairwise_unions<N>(unions.sets(), edges);
 }
 
 /**
@@ -227,29 +273,47 @@ int32_t get_leading_ones(const sliceable_set_t<N>& ss) {
 }
 
 /**
- *  Returns true if any pairwise union of two lists of sliceable sets slices all
- *  edges and false otherwise.
+ *  Returns true if any pairwise union of two ranges of sliceable sets slices
+ *  all edges and false otherwise.
  *
- *  The second list is required to be sorted in lexicographic order.
+ *  The second range is required to be sorted in lexicographic order.
  **/
 template <int32_t N>
-bool pairwise_unions_slice_cube(const std::vector<sliceable_set_t<N>>& sets_1,
-                                const std::vector<sliceable_set_t<N>>& sets_2) {
+bool pairwise_unions_slice_cube(const sliceable_set_t<N>* sets_1_begin,
+                                const sliceable_set_t<N>* sets_1_end,
+                                const sliceable_set_t<N>* sets_2_begin,
+                                const sliceable_set_t<N>* sets_2_end) {
   bool slices_all = false;
-  for (const auto& set_1 : sets_1) {
-    const int32_t leading_zeros = get_leading_zeros<N>(set_1);
-    for (auto set_2 = sets_2.rbegin(); set_2 != sets_2.rend(); ++set_2) {
+  for (auto set_1 = sets_1_begin; set_1 != sets_1_end; ++set_1) {
+    const int32_t leading_zeros = get_leading_zeros<N>(*set_1);
+    for (auto set_2 = sets_2_end; set_2 != sets_2_begin;) {
+      --set_2;
       const int32_t leading_ones = get_leading_ones<N>(*set_2);
       if (leading_ones < leading_zeros) {
         break;
       }
-      const auto set_union = set_1 | *set_2;
+      const auto set_union = *set_1 | *set_2;
       slices_all |= set_union.all();
     }
   }
   return slices_all;
 }
 
+/**
+ *  Returns true if any pairwise union of two lists of sliceable sets slices all
+ *  edges and false otherwise.
+ *
+ *  The second list is required to be sorted in lexicographic order.
+ **/
+template <int32_t N>
+bool pairwise_unions_slice_cube(const std::vector<sliceable_set_t<N>>& sets_1,
+                                const std::vector<sliceable_set_t<N>>& sets_2) {
+  return pairwise_unions_slice_cube<N>(sets_1.data(),
+                                       sets_1.data() + sets_1.size(),
+                                       sets_2.data(),
+                                       sets_2.data() + sets_2.size());
+}
+
 /**
  *  Returns the bitstring encoding of a sliceable set in a byte array.
  **/
@@ -283,6 +347,53 @@ sliceable_set_t<N> bytes_to_sliceable_set(
   return ss;
 }
 
+/* The object representation of a sliceable set with the most significant byte
+ * first, so that lexicographically sorted sliceable sets share leading bytes.
+ */
+template <int32_t N>
+using sliceable_set_image_t =
+    std::array<unsigned char, sizeof(sliceable_set_t<N>)>;
+
+/**
+ *  Returns the image of a sliceable set with the most significant byte first.
+ **/
+template <int32_t N>
+sliceable_set_image_t<N> sliceable_set_to_image(const sliceable_set_t<N>& ss) {
+  static_assert(sizeof(sliceable_set_t<N>) % sizeof(uint64_t) == 0,
+                "sliceable sets have to consist of 64-bit words");
+  constexpr std::size_t num_words = sizeof(sliceable_set_t<N>) / 8;
+  uint64_t words[num_words];
+  std::memcpy(words, &ss, sizeof(words));
+  sliceable_set_image_t<N> image;
+  for (std::size_t i = 0; i < num_words; ++i) {
+    const auto word = words[num_words - 1 - i];
+    for (std::size_t j = 0; j < 8; ++j) {
+      image[i * 8 + j] = static_cast<unsigned char>(word >> (56 - 8 * j));
+    }
+  }
+  return image;
+}
+
+/**
+ *  Returns the sliceable set of an image with the most significant byte first.
+ **/
+template <int32_t N>
+sliceable_set_t<N> image_to_sliceable_set(
+    const sliceable_set_image_t<N>& image) {
+  constexpr std::size_t num_words = sizeof(sliceable_set_t<N>) / 8;
+  uint64_t words[num_words];
+  for (std::size_t i = 0; i < num_words; ++i) {
+    uint64_t word = 0;
+    for (std::size_t j = 0; j < 8; ++j) {
+      word = (word << 8) | image[i * 8 + j];
+    }
+    words[num_words - 1 - i] = word;
+  }
+  sliceable_set_t<N> ss;
+  std::memcpy(&ss, words, sizeof(words));
+  return ss;
+}
+
 /**
  *  Writes sliceable sets in binary to a file at the given path.
  **/
@@ -319,6 +430,86 @@ std::vector<sliceable_set_t<N>> read_from_file(
   return sets;
 }
 
+/**
+ *  Stores a sliceable set as a padded record in a byte array of
+ *  padded_record_bytes(N) bytes (see pairwise_kernel.h).
+ **/
+template <int32_t N>
+void sliceable_set_to_padded_record(const sliceable_set_t<N>& ss,
+                                    unsigned char* record) {
+  std::memset(record, 0, padded_record_bytes(N));
+  for (std::size_t e = 0; e < ss.size(); ++e) {
+    if (ss[e]) {
+      // bit e % 64 of little-endian word e / 64
+      record[e / 8] = static_cast<unsigned char>(record[e / 8] | 1 << (e % 8));
+    }
+  }
+}
+
+/**
+ *  Returns the sliceable set stored in a padded record.
+ **/
+template <int32_t N>
+sliceable_set_t<N> padded_record_to_sliceable_set(const unsigned char* record) {
+  sliceable_set_t<N> ss;
+  for (std::size_t e = 0; e < ss.size(); ++e) {
+    ss[e] = (record[e / 8] >> (e % 8)) & 1;
+  }
+  return ss;
+}
+
+/**
+ *  Returns the padded records of a list of sliceable sets, as read from a file
+ *  written by write_to_padded_file.
+ **/
+template <int32_t N>
+std::vector<uint64_t> to_padded_records(
+    const std::vector<sliceable_set_t<N>>& sets) {
+  std::vector<uint64_t> records(sets.size() * padded_record_words(N));
+  auto* bytes = reinterpret_cast<unsigned char*>(records.data());
+  for (std::size_t i = 0; i < sets.size(); ++i) {
+    sliceable_set_to_padded_record<N>(sets[i],
+                                      bytes + i * padded_record_bytes(N));
+  }
+  return records;
+}
+
+/**
+ *  Writes sliceable sets as padded records to a file at the given path, which
+ *  can be scanned by pairwise_unions_slice_cube_padded without conversion.
+ **/
+template <int32_t N>
+void write_to_padded_file(const std::vector<sliceable_set_t<N>>& sets,
+                          const std::filesystem::path& path) {
+  std::ofstream file(path, std::ios::binary);
+  std::vector<unsigned char> record(padded_record_bytes(N));
+  for (const auto& ss : sets) {
+    sliceable_set_to_padded_record<N>(ss, record.data());
+    file.write(reinterpret_cast<const char*>(record.data()),
+               static_cast<std::streamsize>(record.size()));
+  }
+}
+
+/**
+ *  Returns the sliceable sets stored as padded records in a file at the given
+ *  path (see write_to_padded_file).
+ **/
+template <int32_t N>
+std::vector<sliceable_set_t<N>> read_from_padded_file(
+    const std::filesystem::path& path) {
+  std::vector<unsigned char> record(padded_record_bytes(N));
+  const auto num_sets = std::filesystem::file_size(path) / record.size();
+  std::vector<sliceable_set_t<N>> sets;
+  sets.reserve(num_sets);
+  std::ifstream file(path, std::ios::binary);
+  for (std::size_t i = 0; i < num_sets; ++i) {
+    file.read(reinterpret_cast<char*>(record.data()),
+              static_cast<std::streamsize>(record.size()));
+    sets.push_back(padded_record_to_sliceable_set<N>(record.data()));
+  }
+  return sets;
+}
+
 }  // namespace ncube
 
 #endif  // N_CUBE_SLICEABLE_SET_H_
@@ -0,0 +1,156 @@
+#ifndef N_CUBE_STABILIZER_H_
+#define N_CUBE_STABILIZER_H_
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "bitset_comparator.hpp"
+#include "edge.hpp"
+#include "signature.hpp"
+#include "sliceable_set.hpp"
+#include "vertex.hpp"
+
+namespace ncube {
+
+/* A symmetric transformation given by the image of every edge. */
+template <int32_t N>
+using edge_map_t = std::array<int32_t, num_edges(N)>;
+
+/**
+ *  Returns the edge map of the symmetric transformation given by a permutation
+ *  and signs (see transform_edge).
+ **/
+template <int32_t N>
+edge_map_t<N> compute_edge_map(const std::array<int32_t, N>& permutation,
+                               int32_t signs, const edge_lexicon_t<N>& edges) {
+  const auto permuted = permute_edges<N>(permutation, edges);
+  const vertex_t permuted_signs = transform_vertex<N>(signs, permutation, 0);
+  edge_map_t<N> edge_map;
+  for (int32_t e = 0; e < num_edges(N); ++e) {
+    edge_map[e] = transform_edge_int<N>(permuted, e, permuted_signs);
+  }
+  return edge_map;
+}
+
+/**
+ *  Returns the transformation of a sliceable set by an edge map.
+ **/
+template <int32_t N>
+sliceable_set_t<N> apply_edge_map(const sliceable_set_t<N>& ss,
+                                  const edge_map_t<N>& edge_map) {
+  sliceable_set_t<N> ss_trans;
+  for (int32_t e = 0; e < num_edges(N); ++e) {
+    ss_trans[edge_map[e]] = ss[e];
+  }
+  return ss_trans;
+}
+
+/**
+ *  Returns the stabilizer of a sliceable set, i.e. the symmetric
+ *  transformations that map the sliceable set onto itself, in a fixed order.
+ *
+ *  A transformation is rejected as soon as it maps an edge of the sliceable
+ *  set to an edge that isn't in the sliceable set, so most transformations
+ *  only cost a few edge transformations.
+ **/
+template <int32_t N>
+std::vector<edge_map_t<N>> compute_stabilizer(const sliceable_set_t<N>& ss,
+                                              const edge_lexicon_t<N>& edges) {
+  std::vector<int32_t> ss_edges;
+  for (int32_t e = 0; e < num_edges(N); ++e) {
+    if (ss[e]) {
+      ss_edges.push_back(e);
+    }
+  }
+  std::vector<edge_map_t<N>> stabilizer;
+  for (const auto& permutation : permutations<N>) {
+    const auto permuted = permute_edges<N>(permutation, edges);
+    for (int32_t signs = 0; signs < num_vertices(N); ++signs) {
+      const auto permuted_signs = transform_vertex<N>(signs, permutation, 0);
+      const auto fixes_edge = [&](int32_t e) {
+        return ss[transform_edge_int<N>(permuted, e, permuted_signs)];
+      };
+      if (std::all_of(ss_edges.begin(), ss_edges.end(), fixes_edge)) {
+        stabilizer.push_back(compute_edge_map<N>(permutation, signs, edges));
+      }
+    }
+  }
+  return stabilizer;
+}
+
+/**
+ *  Picks one sliceable set per orbit under the stabilizer of a sliceable set.
+ *
+ *  If a transformation g fixes set_1, then set_1 | g(set_2) = g(set_1 | set_2)
+ *  is equivalent to set_1 | set_2. So set_1 only has to be combined with one
+ *  sliceable set per orbit of its stabilizer in a list, which has to be
+ *  closed under all symmetric transformations, like the symmetry expansions
+ *  of any sliceable sets. The representative of an orbit is its smallest
+ *  sliceable set in lexicographic order, which is decided per sliceable set
+ *  by transforming it by the stabilizer, without storing anything per list.
+ **/
+template <int32_t N>
+class stabilizer_filter {
+ public:
+  stabilizer_filter(const sliceable_set_t<N>& ss,
+                    const edge_lexicon_t<N>& edges)
+      : stabilizer_(compute_stabilizer<N>(ss, edges)) {}
+
+  /**
+   *  Returns true if a sliceable set is the smallest of its orbit under the
+   *  stabilizer and false otherwise.
+   **/
+  bool is_representative(const sliceable_set_t<N>& ss) const {
+    // the stabilizer always contains the identity
+    if (stabilizer_.size() == 1) {
+      return true;
+    }
+    const auto smaller = [&ss](const edge_map_t<N>& edge_map) {
+      return apply_edge_map<N>(ss, edge_map) < ss;
+    };
+    return std::none_of(stabilizer_.begin(), stabilizer_.end(), smaller);
+  }
+
+  /**
+   *  Returns the number of transformations of the stabilizer.
+   **/
+  std::size_t size() const { return stabilizer_.size(); }
+
+ private:
+  std::vector<edge_map_t<N>> stabilizer_;
+};
+
+/**
+ *  Returns the unique symmetric representatives of the pairwise unions of a
+ *  list of sliceable sets and a list of sliceable sets grouped by signature.
+ *  Eliminates non-maximal unions on a best effort basis.
+ *
+ *  Every sliceable set of the first list is only combined with one sliceable
+ *  set per orbit of its stabilizer (see stabilizer_filter), which skips the
+ *  unions that have the same unique symmetric representative. The second list
+ *  has to be closed under all symmetric transformations.
+ *
+ *  The returned sliceable sets are sorted in lexicographic order.
+ **/
+template <int32_t N>
+std::vector<sliceable_set_t<N>> pairwise_unions(
+    const std::vector<sliceable_set_t<N>>& sets_1,
+    const signature_buckets<N>& sets_2, const edge_lexicon_t<N>& edges) {
+  bit_sliced_family<num_edges(N)> unions;
+  for (const auto& set_1 : sets_1) {
+    const stabilizer_filter<N> filter(set_1, edges);
+    for (const auto& set_2 : sets_2.sets()) {
+      if (filter.is_representative(set_2)) {
+        const auto usr = unique_sliceable_set<N>(set_1 | set_2, edges);
+        unions.add_maximal(usr);
+      }
+    }
+  }
+  return finish_pairwise_unions<N>(unions.sets(), edges);
+}
+
+}  // namespace ncube
+
+#endif  // N_CUBE_STABILIZER_H_
@@ -0,0 +1,126 @@
+#ifndef N_CUBE_STAGE_ARENA_H_
+#define N_CUBE_STAGE_ARENA_H_
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+#include "sliceable_set.hpp"
+
+namespace ncube {
+
+/* The size of a transparent huge page on x86-64. */
+constexpr std::size_t huge_page_bytes = std::size_t{1} << 21;
+
+/**
+ *  Asks the kernel to back the huge page aligned part of a memory range with
+ *  transparent huge pages. Returns true if the advice was taken and false
+ *  otherwise, e.g. if the range contains no whole huge page.
+ *
+ *  Only memory mapped by the allocator, like the storage of large vectors,
+ *  can be backed by transparent huge pages.
+ **/
+bool advise_huge_pages(const void* data, std::size_t bytes) {
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  const auto begin = reinterpret_cast<std::uintptr_t>(data);
+  const auto first = (begin + huge_page_bytes - 1) / huge_page_bytes;
+  const auto last = (begin + bytes) / huge_page_bytes;
+  if (first >= last) {
+    return false;
+  }
+  void* aligned = reinterpret_cast<void*>(first * huge_page_bytes);
+  return madvise(aligned, (last - first) * huge_page_bytes, MADV_HUGEPAGE) == 0;
+#else
+  (void)data;
+  (void)bytes;
+  return false;
+#endif
+}
+
+/**
+ *  Recycles the buffers of stages of sliceable sets.
+ *
+ *  A buffer is acquired with the capacity a stage is known or estimated to
+ *  need, so that it is filled without reallocation, and released once the
+ *  stage is no longer needed, so that a later stage reuses its memory instead
+ *  of allocating and faulting in fresh pages. Fresh buffers are advised to be
+ *  backed by transparent huge pages.
+ **/
+template <int32_t N>
+class stage_arena {
+ public:
+  using buffer_t = std::vector<sliceable_set_t<N>>;
+
+  /**
+   *  Returns an empty buffer with at least the given capacity, reusing the
+   *  smallest released buffer that is large enough if there is any and else
+   *  freeing a released buffer.
+   **/
+  buffer_t acquire(std::size_t capacity) {
+    auto best = buffers_.end();
+    for (auto it = buffers_.begin(); it != buffers_.end(); ++it) {
+      if (it->capacity() >= capacity &&
+          (best == buffers_.end() || it->capacity() < best->capacity())) {
+        best = it;
+      }
+    }
+    if (best != buffers_.end()) {
+      buffer_t buffer = std::move(*best);
+      buffers_.erase(best);
+      ++num_reused_;
+      return buffer;
+    }
+    // a released buffer that is too small is freed rather than kept
+    if (!buffers_.empty()) {
+      buffers_.pop_back();
+    }
+    buffer_t buffer;
+    buffer.reserve(capacity);
+    advise_huge_pages(buffer.data(), capacity * sizeof(sliceable_set_t<N>));
+    ++num_allocated_;
+    return buffer;
+  }
+
+  /**
+   *  Returns a buffer to the arena for reuse.
+   **/
+  void release(buffer_t&& buffer) {
+    buffer.clear();
+    if (buffer.capacity() > 0) {
+      buffers_.push_back(std::move(buffer));
+    }
+  }
+
+  /**
+   *  Frees all released buffers.
+   **/
+  void clear() { buffers_.clear(); }
+
+  std::size_t num_allocated() const { return num_allocated_; }
+
+  std::size_t num_reused() const { return num_reused_; }
+
+ private:
+  std::vector<buffer_t> buffers_;
+  std::size_t num_allocated_ = 0;
+  std::size_t num_reused_ = 0;
+};
+
+/**
+ *  Returns the arena shared by all stages of sliceable sets of the n-cube, so
+ *  that the buffers of one engine are reused by the next one. The arena isn't
+ *  thread-safe and is only used by the thread running the engines.
+ **/
+template <int32_t N>
+stage_arena<N>& default_stage_arena() {
+  static stage_arena<N> arena;
+  return arena;
+}
+
+}  // namespace ncube
+
+#endif  // N_CUBE_STAGE_ARENA_H_
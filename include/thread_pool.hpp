@@ -0,0 +1,385 @@
+#ifndef N_CUBE_THREAD_POOL_H_
+#define N_CUBE_THREAD_POOL_H_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "numa.hpp"
+
+namespace ncube {
+
+/* The work done by a participant of a thread pool. */
+struct thread_load_t {
+  uint64_t num_chunks = 0;
+  uint64_t num_stolen = 0;
+  double busy_seconds = 0.0;
+};
+
+/**
+ *  A pool of threads that runs chunks of parallel loops with work stealing.
+ *
+ *  The participants of a pool are its worker threads and the calling thread,
+ *  which is the last participant. A loop is split into chunks that are dealt
+ *  to the participants in contiguous blocks. Every participant runs the chunks
+ *  of its own block from the back and then steals chunks of other blocks from
+ *  the front, so participants that finish early take over the work of slow
+ *  ones.
+ *
+ *  If a task throws, the first exception is rethrown on the calling thread
+ *  after all tasks returned. The remaining chunks of a loop are skipped then.
+ *
+ *  Only one thread may call parallel_for or run_concurrently at a time, and
+ *  not from within a task of the pool.
+ **/
+class thread_pool {
+ public:
+  /**
+   *  Starts a pool of num_threads participants, i.e. num_threads - 1 worker
+   *  threads.
+   **/
+  explicit thread_pool(unsigned int num_threads)
+      : num_threads_(std::max(num_threads, 1u)),
+        queues_(new queue_t[num_threads_]),
+        loads_(num_threads_) {
+    for (unsigned int i = 0; i + 1 < num_threads_; ++i) {
+      workers_.push_back(std::thread(&thread_pool::worker_loop, this, i));
+    }
+  }
+
+  thread_pool(const thread_pool&) = delete;
+  thread_pool& operator=(const thread_pool&) = delete;
+
+  ~thread_pool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto& t : workers_) {
+      t.join();
+    }
+  }
+
+  /**
+   *  Returns the number of participants.
+   **/
+  unsigned int size() const { return num_threads_; }
+
+  /**
+   *  Calls f(i, begin, end) for ranges [begin, end) of at most grain units of
+   *  work covering m units of work, where i < size() is the index of the
+   *  participant. Returns after all calls returned.
+   *
+   *  If grain is 0, the work is split into about 16 chunks per participant.
+   **/
+  template <typename F>
+  void parallel_for(std::size_t m, std::size_t grain, F f) {
+    if (m == 0) {
+      return;
+    }
+    if (grain == 0) {
+      grain = std::max<std::size_t>(m / (16 * num_threads_), 1);
+    }
+    const std::size_t num_chunks = (m + grain - 1) / grain;
+    job_t job{[&f](unsigned int i, std::size_t begin, std::size_t end) {
+                f(i, begin, end);
+              },
+              true};
+    job.num_pending = num_chunks;
+    // participant p gets the chunks [num_chunks * p / size(), ...)
+    for (unsigned int p = 0; p < num_threads_; ++p) {
+      const auto first = num_chunks * p / num_threads_;
+      const auto last = num_chunks * (p + 1) / num_threads_;
+      std::lock_guard<std::mutex> lock(queues_[p].mutex);
+      for (auto c = first; c < last; ++c) {
+        queues_[p].chunks.push_back(
+            {c * grain, std::min((c + 1) * grain, m), &job});
+      }
+    }
+    run(job);
+    rethrow_if_failed(job);
+  }
+
+  /**
+   *  Calls f(t) for every task t < num_tasks such that all calls run at the
+   *  same time, as required by tasks waiting for each other. Returns after all
+   *  calls returned.
+   *
+   *  Every participant runs at most one task. The tasks beyond the number of
+   *  participants get temporary threads of their own.
+   **/
+  template <typename F>
+  void run_concurrently(unsigned int num_tasks, F f) {
+    const unsigned int num_pooled = std::min(num_tasks, num_threads_);
+    job_t job{[&f](unsigned int, std::size_t begin, std::size_t) {
+                f(static_cast<unsigned int>(begin));
+              },
+              false};
+    std::vector<std::thread> overflow;
+    for (unsigned int t = num_pooled; t < num_tasks; ++t) {
+      overflow.push_back(std::thread([this, &job, t] {
+        try {
+          job.f(0, t, t + 1);
+        } catch (...) {
+          fail(job);
+        }
+      }));
+    }
+    job.num_pending = num_pooled;
+    // the calling thread is the last participant, so it runs a task
+    const unsigned int first = num_threads_ - num_pooled;
+    for (unsigned int t = 0; t < num_pooled; ++t) {
+      std::lock_guard<std::mutex> lock(queues_[first + t].mutex);
+      queues_[first + t].chunks.push_back({t, t + 1, &job});
+    }
+    run(job);
+    for (auto& t : overflow) {
+      t.join();
+    }
+    rethrow_if_failed(job);
+  }
+
+  /**
+   *  Pins the participants to the NUMA nodes in contiguous blocks (see
+   *  node_of_participant), including the calling thread. Returns false if
+   *  pinning failed for any participant and true otherwise.
+   **/
+  bool pin_to_nodes(const numa_topology_t& nodes) {
+    std::atomic<bool> pinned(true);
+    run_concurrently(num_threads_, [&](unsigned int t) {
+      const auto node = node_of_participant(t, num_threads_, nodes.size());
+      if (!pin_current_thread(nodes[node])) {
+        pinned = false;
+      }
+    });
+    return pinned;
+  }
+
+  /**
+   *  Returns the work done by every participant since the last reset.
+   **/
+  const std::vector<thread_load_t>& loads() const { return loads_; }
+
+  void reset_loads() { loads_.assign(num_threads_, thread_load_t()); }
+
+ private:
+  struct job_t {
+    std::function<void(unsigned int, std::size_t, std::size_t)> f;
+    // the chunks of a loop are independent and may be stolen or skipped, the
+    // tasks of run_concurrently may wait for each other and always run
+    bool stealable;
+    std::atomic<std::size_t> num_pending{0};
+    std::atomic<bool> failed{false};
+    // the first exception thrown by a chunk, guarded by the pool's mutex
+    std::exception_ptr error = nullptr;
+  };
+
+  struct chunk_t {
+    std::size_t begin;
+    std::size_t end;
+    job_t* job;
+  };
+
+  struct queue_t {
+    std::mutex mutex;
+    std::deque<chunk_t> chunks;
+  };
+
+  /**
+   *  Wakes the workers, runs chunks on the calling thread and waits until all
+   *  chunks of a job are done. The chunks have to be queued and counted in
+   *  num_pending before, since workers may still be taking chunks.
+   **/
+  void run(job_t& job) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ++generation_;
+    }
+    wake_.notify_all();
+    work(num_threads_ - 1);
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [&job] { return job.num_pending == 0; });
+  }
+
+  /**
+   *  Records the exception being handled as the error of a job, unless the
+   *  job failed before.
+   **/
+  void fail(job_t& job) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!job.error) {
+      job.error = std::current_exception();
+    }
+    job.failed = true;
+  }
+
+  void rethrow_if_failed(job_t& job) {
+    if (job.error) {
+      std::rethrow_exception(job.error);
+    }
+  }
+
+  /**
+   *  Takes a chunk of the own queue or steals one from another queue.
+   **/
+  bool take(unsigned int i, chunk_t& chunk, bool& stolen) {
+    {
+      std::lock_guard<std::mutex> lock(queues_[i].mutex);
+      if (!queues_[i].chunks.empty()) {
+        chunk = queues_[i].chunks.back();
+        queues_[i].chunks.pop_back();
+        stolen = false;
+        return true;
+      }
+    }
+    for (unsigned int j = 1; j < num_threads_; ++j) {
+      auto& queue = queues_[(i + j) % num_threads_];
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      if (!queue.chunks.empty() && queue.chunks.front().job->stealable) {
+        chunk = queue.chunks.front();
+        queue.chunks.pop_front();
+        stolen = true;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void work(unsigned int i) {
+    chunk_t chunk;
+    bool stolen;
+    while (take(i, chunk, stolen)) {
+      const auto start = std::chrono::steady_clock::now();
+      // the chunks of a failed loop are still taken and counted down, so
+      // that run returns only once no participant refers to the job
+      if (!chunk.job->failed || !chunk.job->stealable) {
+        try {
+          chunk.job->f(i, chunk.begin, chunk.end);
+        } catch (...) {
+          fail(*chunk.job);
+        }
+      }
+      const std::chrono::duration<double> elapsed =
+          std::chrono::steady_clock::now() - start;
+      loads_[i].num_chunks += 1;
+      loads_[i].num_stolen += stolen;
+      loads_[i].busy_seconds += elapsed.count();
+      if (--chunk.job->num_pending == 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        done_.notify_all();
+      }
+    }
+  }
+
+  void worker_loop(unsigned int i) {
+    uint64_t generation = 0;
+    for (;;) {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        wake_.wait(lock, [&] { return stop_ || generation_ != generation; });
+        if (stop_) {
+          return;
+        }
+        generation = generation_;
+      }
+      work(i);
+    }
+  }
+
+  unsigned int num_threads_;
+  std::unique_ptr<queue_t[]> queues_;
+  std::vector<thread_load_t> loads_;
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable done_;
+  uint64_t generation_ = 0;
+  bool stop_ = false;
+};
+
+/**
+ *  Returns the number of threads requested for the default thread pool, or
+ *  0 if none was requested.
+ **/
+unsigned int& requested_num_threads() {
+  static unsigned int num_threads = 0;
+  return num_threads;
+}
+
+/**
+ *  Returns true if pinning the threads of the default thread pool to NUMA
+ *  nodes was requested by configure_threads or by setting the environment
+ *  variable N_CUBE_PIN_THREADS to 1.
+ **/
+bool& requested_pin_threads() {
+  static bool pin_threads = [] {
+    const char* env = std::getenv("N_CUBE_PIN_THREADS");
+    return env && std::strcmp(env, "1") == 0;
+  }();
+  return pin_threads;
+}
+
+/**
+ *  Returns the thread pool used by all parallelized functions. Its number of
+ *  threads is the one requested by configure_threads, otherwise the value of
+ *  the environment variable N_CUBE_THREADS, otherwise the number of hardware
+ *  threads. If requested, the threads are pinned to the NUMA nodes.
+ **/
+thread_pool& default_thread_pool() {
+  static thread_pool pool([] {
+    if (requested_num_threads() > 0) {
+      return requested_num_threads();
+    }
+    if (const char* env = std::getenv("N_CUBE_THREADS")) {
+      const auto num_threads = std::strtoul(env, nullptr, 10);
+      if (num_threads > 0) {
+        return static_cast<unsigned int>(num_threads);
+      }
+    }
+    return std::thread::hardware_concurrency();
+  }());
+  static const bool pinned =
+      requested_pin_threads() && pool.pin_to_nodes(numa_topology());
+  (void)pinned;
+  return pool;
+}
+
+/**
+ *  Requests the number of threads of the default thread pool given by the
+ *  command line option --threads N or --threads=N, and pinning its threads to
+ *  the NUMA nodes by the option --pin-threads, if present. Has to be called
+ *  before the default thread pool is used.
+ **/
+void configure_threads(int argc, char* argv[]) {
+  for (int i = 1; i < argc; ++i) {
+    const char* value = nullptr;
+    if (std::strcmp(argv[i], "--pin-threads") == 0) {
+      requested_pin_threads() = true;
+    } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+      value = argv[i + 1];
+    } else if (std::strncmp(argv[i], "--threads=", 10) == 0) {
+      value = argv[i] + 10;
+    }
+    if (value) {
+      requested_num_threads() =
+          static_cast<unsigned int>(std::strtoul(value, nullptr, 10));
+    }
+  }
+}
+
+}  // namespace ncube
+
+#endif  // N_CUBE_THREAD_POOL_H_
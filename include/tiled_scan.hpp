@@ -0,0 +1,206 @@
+#ifndef N_CUBE_TILED_SCAN_H_
+#define N_CUBE_TILED_SCAN_H_
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+#include "sliceable_set.hpp"
+
+namespace ncube {
+
+/* The sizes of the blocks of a tiled scan: a tile pairs sets_1 sliceable sets
+ * of the first list with sets_2_bytes bytes of the second list. */
+struct tile_sizes_t {
+  std::size_t sets_1;
+  std::size_t sets_2_bytes;
+};
+
+/* The number of sliceable sets of the first list a tuning scan samples by
+ * default, enough to time every block size of tune_tile_sizes. */
+constexpr std::size_t tile_tuning_sets = 256;
+
+/**
+ *  Returns the size of the L2 cache of the first CPU in bytes, or 256 KiB if
+ *  it is unknown.
+ **/
+std::size_t l2_cache_bytes() {
+#ifdef _SC_LEVEL2_CACHE_SIZE
+  const long bytes = sysconf(_SC_LEVEL2_CACHE_SIZE);
+  if (bytes > 0) {
+    return static_cast<std::size_t>(bytes);
+  }
+#endif
+  // e.g. "2048K"
+  std::ifstream file("/sys/devices/system/cpu/cpu0/cache/index2/size");
+  std::string size;
+  if (file >> size && !size.empty()) {
+    const std::size_t unit = (size.back() == 'K')   ? 1024
+                             : (size.back() == 'M') ? 1024 * 1024
+                                                    : 1;
+    const auto value = std::stoul(size);
+    if (value > 0) {
+      return value * unit;
+    }
+  }
+  return 256 * 1024;
+}
+
+/**
+ *  Returns the tile sizes used by pairwise_unions_slice_cube_tiled. Initially,
+ *  a tile of the second list fills half of the L2 cache, so that the next tile
+ *  can be prefetched next to it, and see tune_tile_sizes.
+ **/
+tile_sizes_t& default_tile_sizes() {
+  static tile_sizes_t sizes{64, l2_cache_bytes() / 2};
+  return sizes;
+}
+
+/**
+ *  Returns the index of the first sliceable set with at least l leading
+ *  1-bits in a range sorted in lexicographic order, for every l. These
+ *  sliceable sets form a suffix of the range.
+ **/
+template <int32_t N>
+std::vector<std::size_t> leading_ones_suffixes(
+    const sliceable_set_t<N>* sets_begin, const sliceable_set_t<N>* sets_end) {
+  std::vector<std::size_t> suffixes(num_edges(N) + 1);
+  sliceable_set_t<N> min_ss;
+  for (int32_t l = 0; l <= num_edges(N); ++l) {
+    if (l > 0) {
+      min_ss[num_edges(N) - l] = true;
+    }
+    const auto it = std::lower_bound(sets_begin, sets_end, min_ss);
+    suffixes[l] = static_cast<std::size_t>(it - sets_begin);
+  }
+  return suffixes;
+}
+
+/**
+ *  Returns true if any pairwise union of two ranges of sliceable sets slices
+ *  all edges and false otherwise.
+ *
+ *  Like pairwise_unions_slice_cube, but cache-blocked: Every sliceable set of
+ *  the first range is paired with the suffix of the second range with enough
+ *  leading 1-bits, whose start is found by binary search. The first range is
+ *  ordered by the start of its suffix, and a block of it is scanned tile by
+ *  tile against the second range from the back, so that a tile is read from
+ *  cache by all sliceable sets of the block whose suffix reaches it, while the
+ *  next tile is prefetched.
+ *
+ *  The second range is required to be sorted in lexicographic order.
+ **/
+template <int32_t N>
+bool pairwise_unions_slice_cube_tiled(
+    const sliceable_set_t<N>* sets_1_begin,
+    const sliceable_set_t<N>* sets_1_end,
+    const sliceable_set_t<N>* sets_2_begin,
+    const sliceable_set_t<N>* sets_2_end,
+    const tile_sizes_t& sizes = default_tile_sizes()) {
+  const auto suffixes = leading_ones_suffixes<N>(sets_2_begin, sets_2_end);
+  const auto num_sets_2 = static_cast<std::size_t>(sets_2_end - sets_2_begin);
+  // the first range ordered by the start of the suffix it is paired with
+  std::vector<std::pair<std::size_t, sliceable_set_t<N>>> sets_1;
+  sets_1.reserve(static_cast<std::size_t>(sets_1_end - sets_1_begin));
+  for (auto set_1 = sets_1_begin; set_1 != sets_1_end; ++set_1) {
+    const auto suffix = suffixes[get_leading_zeros<N>(*set_1)];
+    if (suffix < num_sets_2) {
+      sets_1.emplace_back(suffix, *set_1);
+    }
+  }
+  const auto by_suffix = [](const auto& x, const auto& y) {
+    return x.first < y.first;
+  };
+  std::sort(sets_1.begin(), sets_1.end(), by_suffix);
+  const auto tile = std::max<std::size_t>(
+      sizes.sets_2_bytes / sizeof(sliceable_set_t<N>), 1);
+  const auto block = std::max<std::size_t>(sizes.sets_1, 1);
+  for (std::size_t b = 0; b < sets_1.size(); b += block) {
+    const auto block_begin = sets_1.begin() + b;
+    const auto block_end = sets_1.begin() + std::min(b + block, sets_1.size());
+    // the first sliceable set of the block has the longest suffix
+    const auto block_suffix = block_begin->first;
+    for (auto tile_end = num_sets_2; tile_end > block_suffix;) {
+      const auto tile_begin =
+          (tile_end - block_suffix > tile) ? tile_end - tile : block_suffix;
+      const auto next_begin =
+          (tile_begin - block_suffix > tile) ? tile_begin - tile : block_suffix;
+      const auto next =
+          reinterpret_cast<const char*>(sets_2_begin + next_begin);
+      const auto next_bytes =
+          (tile_begin - next_begin) * sizeof(sliceable_set_t<N>);
+      for (std::size_t byte = 0; byte < next_bytes; byte += 64) {
+        __builtin_prefetch(next + byte);
+      }
+      bool slices_all = false;
+      for (auto it = block_begin; it != block_end && it->first < tile_end;
+           ++it) {
+        const auto& set_1 = it->second;
+        const auto begin = sets_2_begin + std::max(it->first, tile_begin);
+        for (auto set_2 = begin; set_2 != sets_2_begin + tile_end; ++set_2) {
+          slices_all |= (set_1 | *set_2).all();
+        }
+      }
+      if (slices_all) {
+        return true;
+      }
+      tile_end = tile_begin;
+    }
+  }
+  return false;
+}
+
+template <int32_t N>
+bool pairwise_unions_slice_cube_tiled(
+    const std::vector<sliceable_set_t<N>>& sets_1,
+    const std::vector<sliceable_set_t<N>>& sets_2,
+    const tile_sizes_t& sizes = default_tile_sizes()) {
+  return pairwise_unions_slice_cube_tiled<N>(
+      sets_1.data(), sets_1.data() + sets_1.size(), sets_2.data(),
+      sets_2.data() + sets_2.size(), sizes);
+}
+
+/**
+ *  Times the tiled scan of a sample of the first range against the second
+ *  range for tiles of a quarter, half and all of the L2 cache and blocks of
+ *  16 to 256 sliceable sets, stores the fastest tile sizes as the default and
+ *  returns them.
+ *
+ *  The sample should be a scan that doesn't slice all edges, because a scan
+ *  that does stops early.
+ **/
+template <int32_t N>
+tile_sizes_t tune_tile_sizes(const sliceable_set_t<N>* sets_1_begin,
+                             const sliceable_set_t<N>* sets_1_end,
+                             const sliceable_set_t<N>* sets_2_begin,
+                             const sliceable_set_t<N>* sets_2_end) {
+  const auto l2_bytes = l2_cache_bytes();
+  tile_sizes_t best = default_tile_sizes();
+  double best_seconds = -1;
+  for (const std::size_t sets_1 : {16, 64, 256}) {
+    for (const std::size_t divisor : {4, 2, 1}) {
+      const tile_sizes_t sizes{sets_1, l2_bytes / divisor};
+      const auto start = std::chrono::steady_clock::now();
+      pairwise_unions_slice_cube_tiled<N>(sets_1_begin, sets_1_end,
+                                          sets_2_begin, sets_2_end, sizes);
+      const std::chrono::duration<double> seconds =
+          std::chrono::steady_clock::now() - start;
+      if (best_seconds < 0 || seconds.count() < best_seconds) {
+        best = sizes;
+        best_seconds = seconds.count();
+      }
+    }
+  }
+  default_tile_sizes() = best;
+  return best;
+}
+
+}  // namespace ncube
+
+#endif  // N_CUBE_TILED_SCAN_H_
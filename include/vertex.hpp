@@ -19,7 +19,7 @@ constexpr int32_t num_vertices(int32_t n) { return 1 << n; }
 /**
  *  Returns the i-th coordinate of a vertex.
  **/
-int32_t get_coordinate(vertex_t v, int32_t i) {
+constexpr int32_t get_coordinate(vertex_t v, int32_t i) {
   const int32_t mask = 1 << i;
   return (v & mask) ? 1 : -1;
 }
@@ -29,7 +29,7 @@ int32_t get_coordinate(vertex_t v, int32_t i) {
  *
  *  The i-th neighbour of a vertex is the vertex which differs in coordinate i.
  **/
-vertex_t get_neighbour(vertex_t v, int32_t i) {
+constexpr vertex_t get_neighbour(vertex_t v, int32_t i) {
   const int32_t mask = 1 << i;
   return v ^ mask;
 }
@@ -41,8 +41,9 @@ vertex_t get_neighbour(vertex_t v, int32_t i) {
  *  its sign is flipped if the i-th least significant bit of signs is set.
  **/
 template <int32_t N>
-vertex_t transform_vertex(vertex_t v, const std::array<int32_t, N>& permutation,
-                          int32_t signs) {
+constexpr vertex_t transform_vertex(vertex_t v,
+                                    const std::array<int32_t, N>& permutation,
+                                    int32_t signs) {
   vertex_t v_trans = 0;
   for (int32_t i = 0; i < N; ++i) {
     const bool change_sign = (signs >> i) & 1;
@@ -54,6 +55,59 @@ vertex_t transform_vertex(vertex_t v, const std::array<int32_t, N>& permutation,
   return v_trans;
 }
 
+/* The number of permutations of the coordinates is n!. */
+constexpr int32_t num_permutations(int32_t n) {
+  return (n <= 1) ? 1 : n * num_permutations(n - 1);
+}
+
+/* All permutations of the coordinates in lexicographic order, i.e. in the
+ * order std::next_permutation enumerates them starting from the identity. */
+template <int32_t N>
+using permutation_table_t =
+    std::array<std::array<int32_t, N>, num_permutations(N)>;
+
+/**
+ *  Returns all permutations of the coordinates in lexicographic order.
+ **/
+template <int32_t N>
+constexpr permutation_table_t<N> compute_permutations() {
+  permutation_table_t<N> permutations{};
+  std::array<int32_t, N> permutation{};
+  for (int32_t i = 0; i < N; ++i) {
+    permutation[i] = i;
+  }
+  for (int32_t p = 0; p < num_permutations(N); ++p) {
+    permutations[p] = permutation;
+    // the next permutation swaps the last ascent with the smallest larger
+    // value behind it and reverses the values behind the ascent
+    int32_t i = N - 2;
+    while (i >= 0 && permutation[i] > permutation[i + 1]) {
+      --i;
+    }
+    if (i < 0) {
+      break;
+    }
+    int32_t j = N - 1;
+    while (permutation[j] < permutation[i]) {
+      --j;
+    }
+    const int32_t tmp = permutation[i];
+    permutation[i] = permutation[j];
+    permutation[j] = tmp;
+    for (int32_t l = i + 1, r = N - 1; l < r; ++l, --r) {
+      const int32_t tmp_l = permutation[l];
+      permutation[l] = permutation[r];
+      permutation[r] = tmp_l;
+    }
+  }
+  return permutations;
+}
+
+/* The permutations of the coordinates, computed at compile time. */
+template <int32_t N>
+inline constexpr permutation_table_t<N> permutations =
+    compute_permutations<N>();
+
 }  // namespace ncube
 
 #endif  // N_CUBE_VERTEX_H_
@@ -14,7 +14,7 @@ using namespace ncube;
 template <int32_t N>
 std::vector<int64_t> edge_cardinalities_mss(
     std::function<bool(const complex_t<N>&)> is_complex) {
-  const auto edges = compute_edges<N>();
+  const auto& edges = compute_edges<N>();
   const auto complexes = compute_complexes<N>(is_complex);
   const auto usr = complexes_to_usr<N>(complexes, edges);
   std::vector<int64_t> cardinalities(num_edges(N) + 1);
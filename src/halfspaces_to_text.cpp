@@ -0,0 +1,47 @@
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+#include "low_weight.hpp"
+
+using namespace ncube;
+
+/**
+ *  Converts the halfspace records written by write_hyperplanes to text files
+ *  next to them.
+ **/
+template <int32_t N>
+void one_weight_halfspaces_to_text() {
+  constexpr auto dir = N_CUBE_OUT_DIR "/one_weight";
+  for (const auto& name : {"/any_threshold_", "/one_threshold_"}) {
+    const auto path = dir + (name + std::to_string(N));
+    if (std::filesystem::exists(path + ".bin")) {
+      halfspace_records_to_text<N>(path + ".bin", path + ".txt");
+    }
+  }
+}
+
+template <int32_t N>
+void low_weight_halfspaces_to_text(int32_t max) {
+  constexpr auto dir = N_CUBE_OUT_DIR "/one_weight";
+  const auto path =
+      dir + ("/max_" + std::to_string(max) + "_" + std::to_string(N));
+  if (std::filesystem::exists(path + ".bin")) {
+    halfspace_records_to_text<N>(path + ".bin", path + ".txt");
+  }
+}
+
+int main() {
+  one_weight_halfspaces_to_text<3>();
+  one_weight_halfspaces_to_text<4>();
+  one_weight_halfspaces_to_text<5>();
+  one_weight_halfspaces_to_text<6>();
+  one_weight_halfspaces_to_text<7>();
+  for (int32_t i = 1; i <= 5; ++i) {
+    low_weight_halfspaces_to_text<3>(i);
+    low_weight_halfspaces_to_text<4>(i);
+    low_weight_halfspaces_to_text<5>(i);
+    low_weight_halfspaces_to_text<6>(i);
+    low_weight_halfspaces_to_text<7>(i);
+  }
+}
@@ -0,0 +1,194 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bitset_comparator.hpp"
+#include "edge.hpp"
+#include "packed_set.hpp"
+#include "sliceable_set.hpp"
+#include "vertex.hpp"
+
+using namespace ncube;
+
+/**
+ *  Returns the seconds taken by f().
+ **/
+template <typename F>
+double time_seconds(F f) {
+  const auto start = std::chrono::steady_clock::now();
+  f();
+  const std::chrono::duration<double> seconds =
+      std::chrono::steady_clock::now() - start;
+  return seconds.count();
+}
+
+/**
+ *  Prints the nanoseconds per operation with sliceable sets and with packed
+ *  sets and the speedup of the packed sets.
+ **/
+void print_times(int32_t n, const std::string& operation, double num_ops,
+                 double seconds_bitset, double seconds_packed) {
+  std::cout << n << "\t" << operation << "\t" << 1e9 * seconds_bitset / num_ops
+            << "\t" << 1e9 * seconds_packed / num_ops << "\t"
+            << seconds_bitset / seconds_packed << std::endl;
+}
+
+/**
+ *  Times the core operations on random sliceable sets of the n-cube with the
+ *  generic sliceable_set_t and with the width-specialized packed_set. The
+ *  results of both are checked to agree.
+ **/
+template <int32_t N>
+void benchmark_packed_sets(std::size_t num_sets) {
+  std::mt19937_64 generator(N);
+  std::vector<sliceable_set_t<N>> sets(num_sets);
+  for (auto& ss : sets) {
+    // dense sets, so that unions often slice most edges
+    for (int32_t e = 0; e < num_edges(N); ++e) {
+      ss[e] = generator() % 4 != 0;
+    }
+  }
+  const auto packed = pack_sets<N>(sets);
+  int64_t checks = 0;
+
+  auto sorted_bitset = sets;
+  auto sorted_packed = packed;
+  const auto seconds_sort_bitset = time_seconds(
+      [&] { std::sort(sorted_bitset.begin(), sorted_bitset.end()); });
+  const auto seconds_sort_packed = time_seconds(
+      [&] { std::sort(sorted_packed.begin(), sorted_packed.end()); });
+  checks += pack_sets<N>(sorted_bitset) != sorted_packed;
+  print_times(N, "sort", static_cast<double>(num_sets), seconds_sort_bitset,
+              seconds_sort_packed);
+
+  // the scan of pairwise_unions_slice_cube without the early exit
+  int64_t all_bitset = 0, all_packed = 0, num_pairs = 0;
+  const auto seconds_scan_bitset = time_seconds([&] {
+    for (const auto& x : sets) {
+      const int32_t leading_zeros = get_leading_zeros<N>(x);
+      for (auto y = sorted_bitset.end(); y != sorted_bitset.begin();) {
+        --y;
+        if (get_leading_ones<N>(*y) < leading_zeros) {
+          break;
+        }
+        all_bitset += (x | *y).all();
+        ++num_pairs;
+      }
+    }
+  });
+  const auto seconds_scan_packed = time_seconds([&] {
+    for (const auto& x : packed) {
+      const int32_t leading_zeros = x.leading_zeros();
+      for (auto y = sorted_packed.end(); y != sorted_packed.begin();) {
+        --y;
+        if (y->leading_ones() < leading_zeros) {
+          break;
+        }
+        all_packed += (x | *y).all();
+      }
+    }
+  });
+  checks += all_bitset != all_packed;
+  print_times(N, "scan", static_cast<double>(num_pairs), seconds_scan_bitset,
+              seconds_scan_packed);
+
+  int64_t count_bitset = 0, count_packed = 0;
+  const auto seconds_count_bitset = time_seconds([&] {
+    for (const auto& ss : sets) {
+      count_bitset += static_cast<int64_t>(ss.count());
+    }
+  });
+  const auto seconds_count_packed = time_seconds([&] {
+    for (const auto& ps : packed) {
+      count_packed += ps.count();
+    }
+  });
+  checks += count_bitset != count_packed;
+  print_times(N, "count", static_cast<double>(num_sets), seconds_count_bitset,
+              seconds_count_packed);
+
+  int64_t leading_bitset = 0, leading_packed = 0;
+  const auto seconds_leading_bitset = time_seconds([&] {
+    for (const auto& ss : sets) {
+      leading_bitset += get_leading_zeros<N>(ss) + get_leading_ones<N>(ss);
+    }
+  });
+  const auto seconds_leading_packed = time_seconds([&] {
+    for (const auto& ps : packed) {
+      leading_packed += ps.leading_zeros() + ps.leading_ones();
+    }
+  });
+  checks += leading_bitset != leading_packed;
+  print_times(N, "leading", static_cast<double>(num_sets),
+              seconds_leading_bitset, seconds_leading_packed);
+
+  std::vector<std::size_t> hashes_bitset, hashes_packed;
+  hashes_bitset.reserve(num_sets);
+  hashes_packed.reserve(num_sets);
+  const auto seconds_hash_bitset = time_seconds([&] {
+    for (const auto& ss : sets) {
+      hashes_bitset.push_back(std::hash<sliceable_set_t<N>>()(ss));
+    }
+  });
+  const auto seconds_hash_packed = time_seconds([&] {
+    for (const auto& ps : packed) {
+      hashes_packed.push_back(std::hash<packed_set<N>>()(ps));
+    }
+  });
+  // the hashes differ, but have to tell apart the same sets
+  const auto num_distinct = [](std::vector<std::size_t> hashes) {
+    std::sort(hashes.begin(), hashes.end());
+    return std::unique(hashes.begin(), hashes.end()) - hashes.begin();
+  };
+  checks += num_distinct(hashes_bitset) != num_distinct(hashes_packed);
+  print_times(N, "hash", static_cast<double>(num_sets), seconds_hash_bitset,
+              seconds_hash_packed);
+
+  // all transformations by the first permutation
+  const auto& edges = compute_edges<N>();
+  const auto permuted = permute_edges<N>(permutations<N>[0], edges);
+  std::vector<sliceable_set_t<N>> trans_bitset;
+  std::vector<packed_set<N>> trans_packed;
+  const auto seconds_trans_bitset = time_seconds([&] {
+    for (const auto& ss : sets) {
+      for (int32_t signs = 0; signs < num_vertices(N); ++signs) {
+        sliceable_set_t<N> ss_trans;
+        for (int32_t e = 0; e < num_edges(N); ++e) {
+          if (ss[e]) {
+            ss_trans[transform_edge_int<N>(permuted, e, signs)] = true;
+          }
+        }
+        trans_bitset.push_back(ss_trans);
+      }
+    }
+  });
+  const auto seconds_trans_packed = time_seconds([&] {
+    for (const auto& ps : packed) {
+      for (int32_t signs = 0; signs < num_vertices(N); ++signs) {
+        trans_packed.push_back(transform_packed_set<N>(ps, permuted, signs));
+      }
+    }
+  });
+  checks += pack_sets<N>(trans_bitset) != trans_packed;
+  print_times(N, "transform",
+              static_cast<double>(num_sets) * num_vertices(N),
+              seconds_trans_bitset, seconds_trans_packed);
+
+  if (checks != 0) {
+    std::cout << N << "\tmismatches\t" << checks << std::endl;
+  }
+}
+
+int main() {
+  std::cout << "n\toperation\tbitset ns\tpacked ns\tspeedup" << std::endl;
+  benchmark_packed_sets<2>(4000);
+  benchmark_packed_sets<3>(4000);
+  benchmark_packed_sets<4>(4000);
+  benchmark_packed_sets<5>(4000);
+  benchmark_packed_sets<6>(2000);
+  benchmark_packed_sets<7>(1000);
+}
@@ -1,9 +1,12 @@
+#include <pthread.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/stat.h>
 #include <time.h>
 
+#include "pairwise_kernel.h"
+
 /**
  *  Returns the size of the file at the given path in bytes.
  **/
@@ -14,7 +17,8 @@ long get_file_size(const char *path) {
 }
 
 /**
- *  Reads the file at the given path into memory and returns the number of bytes
+ *  Reads the file at the given path into memory aligned to 64 bytes, so that
+ *  padded records are aligned to their size, and returns the number of bytes
  *  read.
  **/
 size_t read_from_file(const char *path, char **buf_ptr) {
@@ -23,8 +27,8 @@ size_t read_from_file(const char *path, char **buf_ptr) {
     return 0;
   }
   const size_t file_size = (unsigned long)maybe_file_size;
-  char *buf = (char *)malloc(file_size);
-  if (buf == NULL) {
+  char *buf;
+  if (posix_memalign((void **)&buf, 64, file_size) != 0) {
     return 0;
   }
   FILE *f = fopen(path, "rb");
@@ -61,93 +65,143 @@ void printb(const char *buf, size_t num_bytes) {
   }
 }
 
+/* The size of a chunk of the streamed file, a multiple of every record size. */
+#define CHUNK_BYTES ((size_t)1 << 26)
+
 /**
- *  Returns the number of leading 0-bits in a byte array.
+ *  Reads a file in chunks on a background thread into two buffers in turn, so
+ *  that the next chunk is read while the current chunk is scanned.
  **/
-int get_leading_zeros(const char *buf, size_t num_bytes) {
-  for (size_t i = 0; i < num_bytes; ++i) {
-    for (int j = 7; j >= 0; --j) {
-      if (buf[i] & (1 << j)) {
-        return (int)(i * 8) + 7 - j;
-      }
+struct chunk_reader {
+  FILE *file;
+  char *buffers[2];
+  size_t lengths[2];
+  int full[2];
+  int stop;
+  size_t next_chunk;
+  pthread_mutex_t mutex;
+  pthread_cond_t changed;
+  pthread_t thread;
+};
+
+static void *read_chunks(void *arg) {
+  struct chunk_reader *reader = (struct chunk_reader *)arg;
+  for (size_t chunk = 0;; ++chunk) {
+    const size_t b = chunk % 2;
+    pthread_mutex_lock(&reader->mutex);
+    while (!reader->stop && reader->full[b]) {
+      pthread_cond_wait(&reader->changed, &reader->mutex);
+    }
+    const int stop = reader->stop;
+    pthread_mutex_unlock(&reader->mutex);
+    if (stop) {
+      return NULL;
+    }
+    const size_t length =
+        fread(reader->buffers[b], sizeof(char), CHUNK_BYTES, reader->file);
+    pthread_mutex_lock(&reader->mutex);
+    reader->lengths[b] = length;
+    reader->full[b] = 1;
+    pthread_cond_broadcast(&reader->changed);
+    pthread_mutex_unlock(&reader->mutex);
+    /* an empty chunk marks the end of the file */
+    if (length == 0) {
+      return NULL;
     }
   }
-  return (int)(num_bytes * 8);
 }
 
 /**
- *  Returns the number of leading 1-bits in a byte array.
+ *  Opens the file at the given path and starts reading it. Returns 0 on
+ *  success and -1 otherwise.
  **/
-int get_leading_ones(const char *buf, size_t num_bytes) {
-  for (size_t i = 0; i < num_bytes; ++i) {
-    for (int j = 7; j >= 0; --j) {
-      if (!(buf[i] & (1 << j))) {
-        return (int)(i * 8) + 7 - j;
-      }
+int open_chunk_reader(struct chunk_reader *reader, const char *path) {
+  reader->file = fopen(path, "rb");
+  if (reader->file == NULL) {
+    return -1;
+  }
+  for (size_t b = 0; b < 2; ++b) {
+    if (posix_memalign((void **)&reader->buffers[b], 64, CHUNK_BYTES) != 0) {
+      return -1;
     }
+    reader->lengths[b] = 0;
+    reader->full[b] = 0;
   }
-  return (int)(num_bytes * 8);
+  reader->stop = 0;
+  reader->next_chunk = 0;
+  pthread_mutex_init(&reader->mutex, NULL);
+  pthread_cond_init(&reader->changed, NULL);
+  pthread_create(&reader->thread, NULL, read_chunks, reader);
+  return 0;
 }
 
-/***
- *  Returns true if any pairwise union of two lists of sliceable sets slices all
- *  edges and false otherwise.
- *
- *  The second list is required to be sorted in lexicographic order.
+/**
+ *  Waits for the next chunk and returns its length in bytes, which is 0 at
+ *  the end of the file. The chunk stays valid until the next call.
  **/
-int pairwise_unions_slice_cube(const char *sets_1, size_t sets_1_len,
-                               const char *sets_2, size_t sets_2_len) {
-  for (size_t i = 0; i < sets_1_len; i += 10) {
-    const int leading_zeros = get_leading_zeros(sets_1 + i, 10);
-    const uint64_t mask =
-        (leading_zeros < 64) ? 0xFFFFFFFFFFFFFFFF >> leading_zeros : 0;
-    for (size_t j = sets_2_len - 10; j < sets_2_len; j -= 10) {
-      const uint64_t set_1_a = *(const uint64_t *)(sets_1 + i);
-      const uint64_t set_2_a = *(const uint64_t *)(sets_2 + j);
-      const uint16_t set_1_b = *(const uint16_t *)(sets_1 + i + 8);
-      const uint16_t set_2_b = *(const uint16_t *)(sets_2 + j + 8);
-#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
-      if ((set_2_a | __builtin_bswap64(mask)) != 0xFFFFFFFFFFFFFFFF) {
-        break;
-      }
-#elif __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
-      if ((mss_a | mask) != 0xFFFFFFFFFFFFFFFF) {
-        break;
-      }
-#else
-      const int leading_ones = get_leading_ones(mss + j, 10);
-      if (leading_ones < leading_zeros) {
-        break;
-      }
-#endif
-      const uint64_t a = set_1_a | set_2_a;
-      const uint16_t b = set_1_b | set_2_b;
-      if (a == 0xFFFFFFFFFFFFFFFF && b == 0xFFFF) {
-        return 1;
-      }
-    }
+size_t next_chunk(struct chunk_reader *reader, const char **chunk) {
+  pthread_mutex_lock(&reader->mutex);
+  /* the previous chunk is done, so its buffer can be refilled */
+  if (reader->next_chunk > 0) {
+    reader->full[(reader->next_chunk - 1) % 2] = 0;
+    pthread_cond_broadcast(&reader->changed);
   }
-  return 0;
+  const size_t b = reader->next_chunk % 2;
+  while (!reader->full[b]) {
+    pthread_cond_wait(&reader->changed, &reader->mutex);
+  }
+  const size_t length = reader->lengths[b];
+  if (length > 0) {
+    ++reader->next_chunk;
+  }
+  pthread_mutex_unlock(&reader->mutex);
+  *chunk = reader->buffers[b];
+  return length;
+}
+
+void close_chunk_reader(struct chunk_reader *reader) {
+  pthread_mutex_lock(&reader->mutex);
+  reader->stop = 1;
+  pthread_cond_broadcast(&reader->changed);
+  pthread_mutex_unlock(&reader->mutex);
+  pthread_join(reader->thread, NULL);
+  pthread_cond_destroy(&reader->changed);
+  pthread_mutex_destroy(&reader->mutex);
+  free(reader->buffers[0]);
+  free(reader->buffers[1]);
+  fclose(reader->file);
 }
 
 int main() {
-  const char usr_path[] = N_CUBE_OUT_DIR "/degree_one/5_usr_2.bin";
-  const char mss_path[] = N_CUBE_OUT_DIR "/degree_one/5_mss_2.bin";
-  char *usr, *mss;
-  const size_t usr_len = read_from_file(usr_path, &usr);
-  if (usr_len == 0) {
-    printf("File not found: %s", usr_path);
-    return 1;
-  }
+  const char usr_path[] = N_CUBE_OUT_DIR "/degree_one/5_usr_2.pad";
+  const char mss_path[] = N_CUBE_OUT_DIR "/degree_one/5_mss_2.pad";
+  /* mss_2 is kept in memory, usr_2 is streamed in chunks */
+  char *mss;
   const size_t mss_len = read_from_file(mss_path, &mss);
   if (mss_len == 0) {
     printf("File not found: %s", mss_path);
     return 2;
   }
+  struct chunk_reader usr;
+  if (open_chunk_reader(&usr, usr_path) != 0) {
+    printf("File not found: %s", usr_path);
+    return 1;
+  }
+  const size_t record_bytes = padded_record_bytes(5);
   const clock_t start = clock();
-  const int slices_all = pairwise_unions_slice_cube(usr, usr_len, mss, mss_len);
+  int slices_all = 0;
+  const char *chunk;
+  for (size_t len = next_chunk(&usr, &chunk); len > 0 && !slices_all;
+       len = next_chunk(&usr, &chunk)) {
+    slices_all = pairwise_unions_slice_cube_padded(
+        (const uint64_t *)chunk, len / record_bytes, (const uint64_t *)mss,
+        mss_len / record_bytes, 5);
+  }
   const clock_t end = clock();
+  close_chunk_reader(&usr);
+  free(mss);
   const double duration = ((double)(end - start)) / CLOCKS_PER_SEC;
-  printf("Execution time of pairwise_unions_slice_cube: %f s\n", duration);
+  printf("Execution time of pairwise_unions_slice_cube_padded: %f s\n",
+         duration);
   printf("Can four hyperplanes slice the 5-cube: %d\n", slices_all);
 }
@@ -1,22 +1,38 @@
 #include <chrono>
 #include <iostream>
+#include <vector>
 
+#include "chunk_reader.hpp"
+#include "multithreaded.hpp"
 #include "sliceable_set.hpp"
+#include "thread_pool.hpp"
+#include "tiled_scan.hpp"
 
 using namespace ncube;
 
-int main() {
-  constexpr auto usr_2_path = N_CUBE_OUT_DIR "/degree_one/5_usr_2.bin";
-  constexpr auto mss_2_path = N_CUBE_OUT_DIR "/degree_one/5_mss_2.bin";
-  const auto usr_2 = read_from_file<5>(usr_2_path);
-  const auto mss_2 = read_from_file<5>(mss_2_path);
+int main(int argc, char* argv[]) {
+  configure_threads(argc, argv);
+  constexpr auto usr_2_path = N_CUBE_OUT_DIR "/degree_one/5_usr_2.nss";
+  constexpr auto mss_2_path = N_CUBE_OUT_DIR "/degree_one/5_mss_2.nss";
+  // mss_2 is read into memory first touched by the threads that scan it and,
+  // if they are pinned, replicated on every NUMA node
+  const auto mss_2 = read_set_file_parallel<5>(mss_2_path);
+  const auto replicas = requested_pin_threads()
+                            ? replicate_per_node<5>(mss_2)
+                            : std::vector<std::vector<sliceable_set_t<5>>>();
   const auto start = std::chrono::high_resolution_clock::now();
-  const auto slices_cube = pairwise_unions_slice_cube<5>(usr_2, mss_2);
+  // usr_2 is streamed in chunks, each of which is scanned against mss_2 in
+  // parallel with the tile sizes tuned on a prefix of the first chunk
+  const auto slices_cube =
+      pairwise_unions_slice_cube_streamed<5>(usr_2_path, mss_2, replicas);
   const auto stop = std::chrono::high_resolution_clock::now();
   const auto duration =
       std::chrono::duration_cast<std::chrono::seconds>(stop - start);
-  std::cout << "Execution time of pairwise_unions_slice_cube: "
+  std::cout << "Execution time of pairwise_unions_slice_cube_streamed: "
             << duration.count() << " s" << std::endl;
+  const auto& sizes = default_tile_sizes();
+  std::cout << "Tuned tiles: " << sizes.sets_1 << " sets of usr_2 against "
+            << sizes.sets_2_bytes << " bytes of mss_2" << std::endl;
   std::cout << "Can four hyperplanes slice the 5-cube: " << slices_cube
             << std::endl;
 }
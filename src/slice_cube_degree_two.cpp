@@ -1,26 +1,30 @@
+#include <cstddef>
 #include <cstdint>
+#include <filesystem>
 #include <iostream>
 
+#include "checkpoint.hpp"
 #include "complex.hpp"
 #include "edge.hpp"
 #include "slice_cube.hpp"
 #include "sliceable_set.hpp"
+#include "thread_pool.hpp"
 #include "vertex.hpp"
 
 using namespace ncube;
 
 template <int32_t N>
 int32_t slice_cube_min_degree_two() {
-  const auto edges = compute_edges<N>();
+  const auto& edges = compute_edges<N>();
   const auto complexes = compute_complexes<N>(is_complex_degree_two<N>);
   const auto usr = complexes_to_usr<N>(complexes, edges);
-  const auto k = slice_cube_min<N>(usr, edges);
+  const auto k = slice_cube_min<N>(usr, edges, slice_cube_layered, &std::cout);
   return k;
 }
 
 bool slice_5_cube_with_2_hyperplanes() {
   constexpr int32_t N = 5;
-  const auto edges = compute_edges<N>();
+  const auto& edges = compute_edges<N>();
   const auto complexes = compute_complexes<N>(is_complex_degree_two<N>);
   const auto usr = complexes_to_usr<N>(complexes, edges);
   const auto mss = expand_usr<N>(usr, edges);
@@ -30,31 +34,54 @@ bool slice_5_cube_with_2_hyperplanes() {
 
 bool slice_5_cube_with_3_hyperplanes() {
   constexpr int32_t N = 5;
-  const auto edges = compute_edges<N>();
+  const auto& edges = compute_edges<N>();
   const auto complexes = compute_complexes<N>(is_complex_degree_two<N>);
   const auto usr = complexes_to_usr<N>(complexes, edges);
   const auto mss = expand_usr<N>(usr, edges);
-  for (auto it_1 = mss.rbegin(); it_1 != mss.rend(); ++it_1) {
-    for (auto it_2 = mss.rbegin(); it_2 != mss.rend(); ++it_2) {
-      for (auto it_3 = usr.rbegin(); it_3 != usr.rend(); ++it_3) {
-        if ((*it_1 | *it_2 | *it_3).all()) {
-          return true;
+  // The scan takes days, so the scanned ranges of the first set are kept in a
+  // checkpoint if checkpointing is on.
+  const auto& options = default_checkpoint_options();
+  std::filesystem::path path;
+  if (!options.dir.empty()) {
+    std::filesystem::create_directories(options.dir);
+    path = options.dir / "slice_5_cube_with_3_hyperplanes";
+  }
+  const auto fingerprint = scan_fingerprint<N>(
+      mss.data(), mss.data() + mss.size(), usr.data(), usr.data() + usr.size());
+  scan_checkpoint checkpoint(path, fingerprint, options.resume,
+                             options.flush_seconds);
+  const auto scan = [&](std::size_t begin, std::size_t end) {
+    const auto it_1_end = mss.rbegin() + static_cast<std::ptrdiff_t>(end);
+    for (auto it_1 = mss.rbegin() + static_cast<std::ptrdiff_t>(begin);
+         it_1 != it_1_end; ++it_1) {
+      for (auto it_2 = mss.rbegin(); it_2 != mss.rend(); ++it_2) {
+        for (auto it_3 = usr.rbegin(); it_3 != usr.rend(); ++it_3) {
+          if ((*it_1 | *it_2 | *it_3).all()) {
+            return true;
+          }
         }
       }
     }
-  }
-  return false;
+    return false;
+  };
+  return scan_checkpointed(mss.size(), checkpoint, scan);
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+  configure_threads(argc, argv);
+  configure_checkpoints(argc, argv, N_CUBE_OUT_DIR "/checkpoints");
+  const auto k_2 = slice_cube_min_degree_two<2>();
   std::cout << "Minimum number of degree two polynomials to slice the 2-cube: "
-            << slice_cube_min_degree_two<2>() << std::endl;
+            << k_2 << std::endl;
+  const auto k_3 = slice_cube_min_degree_two<3>();
   std::cout << "Minimum number of degree two polynomials to slice the 3-cube: "
-            << slice_cube_min_degree_two<3>() << std::endl;
+            << k_3 << std::endl;
+  const auto k_4 = slice_cube_min_degree_two<4>();
   std::cout << "Minimum number of degree two polynomials to slice the 4-cube: "
-            << slice_cube_min_degree_two<4>() << std::endl;
+            << k_4 << std::endl;
   std::cout << "Can two degree two polynomials slice the 5-cube: "
             << slice_5_cube_with_2_hyperplanes() << std::endl;
   std::cout << "Can three degree two polynomials slice the 5-cube: "
             << slice_5_cube_with_3_hyperplanes() << std::endl;
+  report_checkpoints(std::cout);
 }
@@ -1,44 +1,67 @@
 #include <cstdint>
 #include <iostream>
 
+#include "checkpoint.hpp"
 #include "edge.hpp"
 #include "low_weight.hpp"
+#include "multithreaded.hpp"
 #include "slice_cube.hpp"
+#include "thread_pool.hpp"
 #include "vertex.hpp"
 
 using namespace ncube;
 
 template <int32_t N>
-int32_t slice_cube_one_weight(const std::vector<int32_t>& thresholds) {
-  const auto edges = compute_edges<N>();
-  const auto mss = compute_one_weight_mss<N>(thresholds, edges);
+int32_t slice_cube_one_weight(const std::vector<int32_t>& thresholds,
+                              slice_cube_method method,
+                              uint64_t upper_bound_steps) {
+  const auto& edges = compute_edges<N>();
+  const auto mss = compute_one_weight_mss_parallel<N>(thresholds, edges);
   const auto usr = reduce_to_usr<N>(mss, edges);
-  const auto k = slice_cube_min<N>(usr, edges);
+  const auto k = slice_cube_min<N>(usr, edges, method, &std::cout,
+                                   upper_bound_steps);
   return k;
 }
 
-int main() {
+/**
+ *  Outputs the stages computed for the n-cube, followed by the result.
+ **/
+template <int32_t N>
+void print_slice_cube_one_weight(const std::vector<int32_t>& thresholds,
+                                 slice_cube_method method,
+                                 uint64_t upper_bound_steps) {
+  const auto k =
+      slice_cube_one_weight<N>(thresholds, method, upper_bound_steps);
+  std::cout << "n = " << N << ": " << k << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+  configure_threads(argc, argv);
+  configure_checkpoints(argc, argv, N_CUBE_OUT_DIR "/checkpoints");
+  const auto method = parse_slice_cube_method(argc, argv);
+  const auto upper_bound_steps = parse_upper_bound_steps(argc, argv);
   std::vector<int32_t> thresholds = {0, 1};
   std::cout << "Minimum number of halfspaces with normal vector in {-1, 1} and "
                "threshold in {0, 1} required to slice the n-cube"
             << std::endl;
-  std::cout << "n = 2: " << slice_cube_one_weight<2>(thresholds) << std::endl;
-  std::cout << "n = 3: " << slice_cube_one_weight<3>(thresholds) << std::endl;
-  std::cout << "n = 4: " << slice_cube_one_weight<4>(thresholds) << std::endl;
-  std::cout << "n = 5: " << slice_cube_one_weight<5>(thresholds) << std::endl;
-  std::cout << "n = 6: " << slice_cube_one_weight<6>(thresholds) << std::endl;
-  std::cout << "n = 7: " << slice_cube_one_weight<7>(thresholds) << std::endl;
+  print_slice_cube_one_weight<2>(thresholds, method, upper_bound_steps);
+  print_slice_cube_one_weight<3>(thresholds, method, upper_bound_steps);
+  print_slice_cube_one_weight<4>(thresholds, method, upper_bound_steps);
+  print_slice_cube_one_weight<5>(thresholds, method, upper_bound_steps);
+  print_slice_cube_one_weight<6>(thresholds, method, upper_bound_steps);
+  print_slice_cube_one_weight<7>(thresholds, method, upper_bound_steps);
   std::cout << "Minimum number of halfspaces with normal vector in {-1, 1} and "
                "threshold in {0, ..., n} required to slice the n-cube"
             << std::endl;
   thresholds.push_back(2);
-  std::cout << "n = 2: " << slice_cube_one_weight<2>(thresholds) << std::endl;
+  print_slice_cube_one_weight<2>(thresholds, method, upper_bound_steps);
   thresholds.push_back(3);
-  std::cout << "n = 3: " << slice_cube_one_weight<3>(thresholds) << std::endl;
+  print_slice_cube_one_weight<3>(thresholds, method, upper_bound_steps);
   thresholds.push_back(4);
-  std::cout << "n = 4: " << slice_cube_one_weight<4>(thresholds) << std::endl;
+  print_slice_cube_one_weight<4>(thresholds, method, upper_bound_steps);
   thresholds.push_back(5);
-  std::cout << "n = 5: " << slice_cube_one_weight<5>(thresholds) << std::endl;
+  print_slice_cube_one_weight<5>(thresholds, method, upper_bound_steps);
   thresholds.push_back(6);
-  std::cout << "n = 6: " << slice_cube_one_weight<6>(thresholds) << std::endl;
+  print_slice_cube_one_weight<6>(thresholds, method, upper_bound_steps);
+  report_checkpoints(std::cout);
 }
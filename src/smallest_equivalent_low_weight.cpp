@@ -1,11 +1,16 @@
 #include <cstdint>
 #include <iostream>
+#include <utility>
+#include <vector>
 
+#include "checkpoint.hpp"
 #include "complex.hpp"
 #include "edge.hpp"
 #include "low_weight.hpp"
+#include "multithreaded.hpp"
 #include "slice_cube.hpp"
 #include "sliceable_set.hpp"
+#include "thread_pool.hpp"
 #include "vertex.hpp"
 
 using namespace ncube;
@@ -19,12 +24,14 @@ template <int32_t N>
 void equivalent_low_weight_mss() {
   std::cout << "n = " << N << std::endl;
   const auto complexes = compute_complexes<N>(is_complex_degree_one<N>);
-  const auto edges = compute_edges<N>();
+  const auto& edges = compute_edges<N>();
   const auto usr = complexes_to_usr<N>(complexes, edges);
   const auto mss = expand_usr<N>(usr, edges);
   std::cout << "  |mss| = " << mss.size() << std::endl;
+  std::vector<sliceable_set_t<N>> mss_low_weight;
   for (int i = 1;; ++i) {
-    const auto mss_low_weight = compute_low_weight_mss<N>(i, edges);
+    mss_low_weight =
+        compute_low_weight_mss_parallel<N>(i, mss_low_weight, edges);
     std::cout << "  |mss_" << i << "| = " << mss_low_weight.size() << std::endl;
     if (mss_low_weight == mss) {
       std::cout << "  smallest i to have equivalent mss is " << i << std::endl;
@@ -39,18 +46,31 @@ void equivalent_low_weight_mss() {
  *  of sliceable sets as in the general setting.
  **/
 template <int32_t N>
-void equivalent_low_weight_slice_cube_min() {
+void equivalent_low_weight_slice_cube_min(slice_cube_method method,
+                                          uint64_t upper_bound_steps) {
   std::cout << "n = " << N << std::endl;
   const auto complexes = compute_complexes<N>(is_complex_degree_one<N>);
-  const auto edges = compute_edges<N>();
+  const auto& edges = compute_edges<N>();
   const auto usr = complexes_to_usr<N>(complexes, edges);
-  const auto k = slice_cube_min<N>(usr, edges);
+  const auto k = slice_cube_min<N>(usr, edges, method, &std::cout,
+                                   upper_bound_steps);
   std::cout << "  k = " << k << std::endl;
+  std::vector<sliceable_set_t<N>> mss_low_weight;
+  int32_t k_low_weight = -1;
   for (int i = 1;; ++i) {
-    const auto mss_low_weight = compute_low_weight_mss<N>(i, edges);
-    const auto usr_low_weight = reduce_to_usr<N>(mss_low_weight, edges);
-    const auto k_low_weight = slice_cube_min<N>(usr_low_weight, k, edges);
-    std::cout << "  k_" << i << " = " << k << std::endl;
+    auto next_mss_low_weight =
+        compute_low_weight_mss_parallel<N>(i, mss_low_weight, edges);
+    // Every stage of slice_cube_min is derived from the previous stage and the
+    // maximal sliceable sets, so the stages are reused all or nothing: they
+    // are kept while no new maximal sliceable sets appear, and a single new one
+    // changes all of them.
+    if (next_mss_low_weight != mss_low_weight) {
+      mss_low_weight = std::move(next_mss_low_weight);
+      const auto usr_low_weight = reduce_to_usr<N>(mss_low_weight, edges);
+      k_low_weight = slice_cube_min<N>(usr_low_weight, k, edges, method,
+                                       &std::cout, upper_bound_steps);
+    }
+    std::cout << "  k_" << i << " = " << k_low_weight << std::endl;
     if (k == k_low_weight) {
       std::cout << "  smallest i to slice the n-cube with the same number of "
                    "hyperplanes is "
@@ -60,13 +80,18 @@ void equivalent_low_weight_slice_cube_min() {
   }
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+  configure_threads(argc, argv);
+  configure_checkpoints(argc, argv, N_CUBE_OUT_DIR "/checkpoints");
+  const auto method = parse_slice_cube_method(argc, argv);
+  const auto upper_bound_steps = parse_upper_bound_steps(argc, argv);
   equivalent_low_weight_mss<2>();
   equivalent_low_weight_mss<3>();
   equivalent_low_weight_mss<4>();
   equivalent_low_weight_mss<5>();
-  equivalent_low_weight_slice_cube_min<2>();
-  equivalent_low_weight_slice_cube_min<3>();
-  equivalent_low_weight_slice_cube_min<4>();
-  equivalent_low_weight_slice_cube_min<5>();
+  equivalent_low_weight_slice_cube_min<2>(method, upper_bound_steps);
+  equivalent_low_weight_slice_cube_min<3>(method, upper_bound_steps);
+  equivalent_low_weight_slice_cube_min<4>(method, upper_bound_steps);
+  equivalent_low_weight_slice_cube_min<5>(method, upper_bound_steps);
+  report_checkpoints(std::cout);
 }
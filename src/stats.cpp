@@ -1,16 +1,23 @@
+#include <chrono>
 #include <cstdint>
+#include <filesystem>
 #include <iostream>
+#include <string>
 
 #include "complex.hpp"
+#include "compressed_sets.hpp"
 #include "edge.hpp"
+#include "packed_set.hpp"
+#include "signature.hpp"
 #include "sliceable_set.hpp"
+#include "tiled_scan.hpp"
 #include "vertex.hpp"
 
 using namespace ncube;
 
 template <int32_t N>
 std::vector<int64_t> compute_edge_frequencies() {
-  const auto edges = compute_edges<N>();
+  const auto& edges = compute_edges<N>();
   const auto complexes = compute_complexes<N>(is_complex_degree_one<N>);
   const auto usr = complexes_to_usr<N>(complexes, edges);
   const auto mss = expand_usr<N>(usr, edges);
@@ -47,15 +54,119 @@ int64_t count_pairs_leading_zeros(const std::vector<sliceable_set_t<N>>& usr,
   }
   int64_t count = 0;
   for (const auto& ss : usr) {
-    for (auto i = get_leading_zeros<N>(ss); i < leading_ones.size(); ++i) {
+    for (auto i = static_cast<std::size_t>(get_leading_zeros<N>(ss));
+         i < leading_ones.size(); ++i) {
       count += leading_ones[i];
     }
   }
   return count;
 }
 
+template <int32_t N>
+int64_t count_pairs_signature(const std::vector<sliceable_set_t<N>>& usr,
+                              const signature_buckets<N>& mss) {
+  int64_t count = 0;
+  for (const auto& ss : usr) {
+    const auto signature = compute_signature<N>(ss, mss.masks());
+    const int32_t leading_zeros = get_leading_zeros<N>(ss);
+    for (std::size_t b = 0; b < mss.num_buckets(); ++b) {
+      if (!signatures_may_slice_cube<N>(signature, mss.signature(b))) {
+        continue;
+      }
+      const auto bucket_begin = mss.bucket_begin(b);
+      for (auto it = mss.bucket_end(b); it != bucket_begin;) {
+        --it;
+        if (get_leading_ones<N>(*it) < leading_zeros) {
+          break;
+        }
+        ++count;
+      }
+    }
+  }
+  return count;
+}
+
+template <int32_t N>
+void print_scan_throughput() {
+  using clock = std::chrono::steady_clock;
+  const auto& edges = compute_edges<N>();
+  const auto complexes = compute_complexes<N>(is_complex_degree_one<N>);
+  const auto usr = complexes_to_usr<N>(complexes, edges);
+  const auto mss = expand_usr<N>(usr, edges);
+  const signature_buckets<N> mss_buckets(mss, edges);
+  const auto pairs_leading_zeros = count_pairs_leading_zeros<N>(usr, mss);
+  const auto pairs_signature = count_pairs_signature<N>(usr, mss_buckets);
+  std::cout << "Pairs by cardinality: " << count_pairs_cardinality<N>(usr, mss)
+            << std::endl;
+  std::cout << "Pairs by leading zeros: " << pairs_leading_zeros << std::endl;
+  std::cout << "Pairs by signature and leading zeros: " << pairs_signature
+            << std::endl;
+  const auto start = clock::now();
+  const bool slices_cube = pairwise_unions_slice_cube<N>(usr, mss);
+  const auto mid = clock::now();
+  const bool slices_cube_signature =
+      pairwise_unions_slice_cube<N>(usr, mss_buckets);
+  const auto mid_tiled = clock::now();
+  const bool slices_cube_tiled = pairwise_unions_slice_cube_tiled<N>(usr, mss);
+  const auto end = clock::now();
+  const auto usr_packed = pack_sets<N>(usr);
+  const auto mss_packed = pack_sets<N>(mss);
+  const auto start_packed = clock::now();
+  const bool slices_cube_packed =
+      pairwise_unions_slice_cube<N>(usr_packed, mss_packed);
+  const auto end_packed = clock::now();
+  const std::chrono::duration<double> seconds = mid - start;
+  const std::chrono::duration<double> seconds_signature = mid_tiled - mid;
+  const std::chrono::duration<double> seconds_tiled = end - mid_tiled;
+  const std::chrono::duration<double> seconds_packed =
+      end_packed - start_packed;
+  std::cout << "Scan by leading zeros: " << slices_cube << " in "
+            << seconds.count() << " s ("
+            << static_cast<double>(usr.size() * mss.size()) / seconds.count()
+            << " pairs/s)" << std::endl;
+  std::cout << "Scan by signature: " << slices_cube_signature << " in "
+            << seconds_signature.count() << " s ("
+            << static_cast<double>(usr.size() * mss.size()) /
+                   seconds_signature.count()
+            << " pairs/s)" << std::endl;
+  std::cout << "Scan in tiles: " << slices_cube_tiled << " in "
+            << seconds_tiled.count() << " s ("
+            << static_cast<double>(usr.size() * mss.size()) /
+                   seconds_tiled.count()
+            << " pairs/s)" << std::endl;
+  std::cout << "Scan packed: " << slices_cube_packed << " in "
+            << seconds_packed.count() << " s ("
+            << static_cast<double>(usr.size() * mss.size()) /
+                   seconds_packed.count()
+            << " pairs/s)" << std::endl;
+  // the compressed maximal sliceable sets written by storage
+  const std::filesystem::path path_compressed =
+      N_CUBE_OUT_DIR "/degree_one/" + std::to_string(N) + "_mss_1.ncs";
+  if (!std::filesystem::exists(path_compressed)) {
+    std::cout << "Scan compressed: " << path_compressed.string()
+              << " not found, run storage first" << std::endl;
+    return;
+  }
+  const auto mss_compressed =
+      compressed_sets<N>::read_from_file(path_compressed);
+  const auto start_compressed = clock::now();
+  const bool slices_cube_compressed =
+      pairwise_unions_slice_cube<N>(usr, mss_compressed);
+  const auto end_compressed = clock::now();
+  const std::chrono::duration<double> seconds_compressed =
+      end_compressed - start_compressed;
+  std::cout << "Scan compressed: " << slices_cube_compressed << " in "
+            << seconds_compressed.count() << " s ("
+            << static_cast<double>(usr.size() * mss.size()) /
+                   seconds_compressed.count()
+            << " pairs/s, " << mss_compressed.compressed_bytes() << " of "
+            << mss.size() * sizeof(sliceable_set_t<N>) << " bytes)"
+            << std::endl;
+}
+
 int main() {
   for (const auto& freq : compute_edge_frequencies<5>()) {
     std::cout << freq << std::endl;
   }
+  print_scan_throughput<5>();
 }
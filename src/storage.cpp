@@ -1,18 +1,41 @@
 #include <algorithm>
 #include <cstdint>
 #include <filesystem>
+#include <iostream>
 #include <string>
 
 #include "complex.hpp"
+#include "compressed_sets.hpp"
 #include "edge.hpp"
+#include "out_of_core.hpp"
+#include "set_file.hpp"
 #include "sliceable_set.hpp"
+#include "thread_pool.hpp"
 #include "vertex.hpp"
 
 using namespace ncube;
 
+/**
+ *  Writes sliceable sets in binary to a file at the given path with extension
+ *  .bin, as padded records with extension .pad and as a set file with
+ *  extension .nss. The symmetry expansions of maximal sliceable sets are also
+ *  written compressed with extension .ncs, which stats scans.
+ **/
+template <int32_t N>
+void write_sets(const std::vector<sliceable_set_t<N>>& sets,
+                const std::string& path, uint32_t flags) {
+  write_to_file<N>(sets, path + ".bin");
+  write_to_padded_file<N>(sets, path + ".pad");
+  write_set_file<N>(sets, path + ".nss", flags);
+  if (flags & set_file_mss) {
+    const compressed_sets<N> compressed(sets);
+    compressed.write_to_file(path + ".ncs");
+  }
+}
+
 template <int32_t N>
 void write_degree_two_1_sliceable_sets() {
-  const auto edges = compute_edges<N>();
+  const auto& edges = compute_edges<N>();
   const auto complexes = compute_complexes<N>(is_complex_degree_two<N>);
   const auto usr = complexes_to_usr<N>(complexes, edges);
   const auto mss = expand_usr<N>(usr, edges);
@@ -20,71 +43,86 @@ void write_degree_two_1_sliceable_sets() {
   std::cout << "degree two |" << N << "_mss_1| = " << mss.size() << std::endl;
   constexpr auto dir = N_CUBE_OUT_DIR "/degree_two";
   std::filesystem::create_directories(dir);
-  const auto path_usr = dir + ("/" + std::to_string(N) + "_usr_1.bin");
-  const auto path_mss = dir + ("/" + std::to_string(N) + "_mss_1.bin");
-  write_to_file<N>(usr, path_usr);
-  write_to_file<N>(mss, path_mss);
+  const auto path_usr = dir + ("/" + std::to_string(N) + "_usr_1");
+  const auto path_mss = dir + ("/" + std::to_string(N) + "_mss_1");
+  write_sets<N>(usr, path_usr, set_file_sorted | set_file_usr);
+  write_sets<N>(mss, path_mss, set_file_sorted | set_file_mss);
 }
 
 template <int32_t N>
-void write_degree_one_1_sliceable_sets() {
-  const auto edges = compute_edges<N>();
+void write_degree_one_2_sliceable_sets() {
+  const auto& edges = compute_edges<N>();
   const auto complexes = compute_complexes<N>(is_complex_degree_one<N>);
-  const auto usr = complexes_to_usr<N>(complexes, edges);
-  const auto mss = expand_usr<N>(usr, edges);
-  std::cout << "degree one |" << N << "_usr_1| = " << usr.size() << std::endl;
-  std::cout << "degree one |" << N << "_mss_1| = " << mss.size() << std::endl;
+  const auto usr_1 = complexes_to_usr<N>(complexes, edges);
+  const auto mss_1 = expand_usr<N>(usr_1, edges);
+  const auto usr_2 = pairwise_unions<N>(usr_1, mss_1, edges);
+  const auto mss_2 = expand_usr<N>(usr_2, edges);
+  std::cout << "degree one |" << N << "_usr_1| = " << usr_1.size() << std::endl;
+  std::cout << "degree one |" << N << "_mss_1| = " << mss_1.size() << std::endl;
+  std::cout << "degree one |" << N << "_usr_2| = " << usr_2.size() << std::endl;
+  std::cout << "degree one |" << N << "_mss_2| = " << mss_2.size() << std::endl;
   constexpr auto dir = N_CUBE_OUT_DIR "/degree_one";
   std::filesystem::create_directories(dir);
-  const auto path_usr = dir + ("/" + std::to_string(N) + "_usr_1.bin");
-  const auto path_mss = dir + ("/" + std::to_string(N) + "_mss_1.bin");
-  write_to_file<N>(usr, path_usr);
-  write_to_file<N>(mss, path_mss);
+  const auto path_usr_1 = dir + ("/" + std::to_string(N) + "_usr_1");
+  const auto path_mss_1 = dir + ("/" + std::to_string(N) + "_mss_1");
+  const auto path_usr_2 = dir + ("/" + std::to_string(N) + "_usr_2");
+  const auto path_mss_2 = dir + ("/" + std::to_string(N) + "_mss_2");
+  write_sets<N>(usr_1, path_usr_1, set_file_sorted | set_file_usr);
+  write_sets<N>(mss_1, path_mss_1, set_file_sorted | set_file_mss);
+  write_sets<N>(usr_2, path_usr_2, set_file_sorted | set_file_usr);
+  write_sets<N>(mss_2, path_mss_2, set_file_sorted | set_file_mss);
 }
 
+/**
+ *  Computes the stages that don't fit into memory in sorted runs on disk. Only
+ *  set files are written.
+ **/
 template <int32_t N>
-void write_degree_one_1_sliceable_sets_only_usr() {
-  const auto edges = compute_edges<N>();
+void write_degree_one_1_sliceable_sets_out_of_core() {
+  const auto& edges = compute_edges<N>();
   const auto complexes = compute_complexes<N>(is_complex_degree_one<N>);
-  const auto usr = complexes_to_usr<N>(complexes, edges);
-  std::cout << "degree one |" << N << "_usr_1| = " << usr.size() << std::endl;
+  const auto usr_1 = complexes_to_usr<N>(complexes, edges);
   constexpr auto dir = N_CUBE_OUT_DIR "/degree_one";
   std::filesystem::create_directories(dir);
-  const auto path_usr = dir + ("/" + std::to_string(N) + "_usr_1.bin");
-  write_to_file<N>(usr, path_usr);
+  const auto path_usr_1 = dir + ("/" + std::to_string(N) + "_usr_1.nss");
+  const auto path_mss_1 = dir + ("/" + std::to_string(N) + "_mss_1.nss");
+  write_set_file<N>(usr_1, path_usr_1, set_file_sorted | set_file_usr);
+  const auto num_mss_1 = expand_usr_to_file<N>(
+      usr_1.data(), usr_1.data() + usr_1.size(), edges, path_mss_1);
+  std::cout << "degree one |" << N << "_usr_1| = " << usr_1.size() << std::endl;
+  std::cout << "degree one |" << N << "_mss_1| = " << num_mss_1 << std::endl;
 }
 
 template <int32_t N>
-void write_degree_one_2_sliceable_sets() {
-  const auto edges = compute_edges<N>();
-  const auto complexes = compute_complexes<N>(is_complex_degree_one<N>);
-  const auto usr_1 = complexes_to_usr<N>(complexes, edges);
-  const auto mss_1 = expand_usr<N>(usr_1, edges);
-  const auto usr_2 = pairwise_unions<N>(usr_1, mss_1, edges);
-  const auto mss_2 = expand_usr<N>(usr_2, edges);
-  std::cout << "degree one |" << N << "_usr_1| = " << usr_1.size() << std::endl;
-  std::cout << "degree one |" << N << "_mss_1| = " << mss_1.size() << std::endl;
-  std::cout << "degree one |" << N << "_usr_2| = " << usr_2.size() << std::endl;
-  std::cout << "degree one |" << N << "_mss_2| = " << mss_2.size() << std::endl;
+void write_degree_one_2_sliceable_sets_out_of_core() {
+  write_degree_one_1_sliceable_sets_out_of_core<N>();
+  const auto& edges = compute_edges<N>();
   constexpr auto dir = N_CUBE_OUT_DIR "/degree_one";
-  std::filesystem::create_directories(dir);
-  const auto path_usr_1 = dir + ("/" + std::to_string(N) + "_usr_1.bin");
-  const auto path_mss_1 = dir + ("/" + std::to_string(N) + "_mss_1.bin");
-  const auto path_usr_2 = dir + ("/" + std::to_string(N) + "_usr_2.bin");
-  const auto path_mss_2 = dir + ("/" + std::to_string(N) + "_mss_2.bin");
-  write_to_file<N>(usr_1, path_usr_1);
-  write_to_file<N>(mss_1, path_mss_1);
-  write_to_file<N>(usr_2, path_usr_2);
-  write_to_file<N>(mss_2, path_mss_2);
+  const auto path_usr_1 = dir + ("/" + std::to_string(N) + "_usr_1.nss");
+  const auto path_mss_1 = dir + ("/" + std::to_string(N) + "_mss_1.nss");
+  const auto path_usr_2 = dir + ("/" + std::to_string(N) + "_usr_2.nss");
+  const auto path_mss_2 = dir + ("/" + std::to_string(N) + "_mss_2.nss");
+  const mapped_set_file<N> usr_1(path_usr_1);
+  const mapped_set_file<N> mss_1(path_mss_1);
+  // eliminate non-maximal unions among the next 1024 unions
+  const auto num_usr_2 =
+      pairwise_unions_to_file<N>(usr_1.begin(), usr_1.end(), mss_1.begin(),
+                                 mss_1.end(), edges, path_usr_2, 1024);
+  std::cout << "degree one |" << N << "_usr_2| = " << num_usr_2 << std::endl;
+  const mapped_set_file<N> usr_2(path_usr_2);
+  const auto num_mss_2 =
+      expand_usr_to_file<N>(usr_2.begin(), usr_2.end(), edges, path_mss_2);
+  std::cout << "degree one |" << N << "_mss_2| = " << num_mss_2 << std::endl;
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+  configure_threads(argc, argv);
   write_degree_one_2_sliceable_sets<2>();
   write_degree_one_2_sliceable_sets<3>();
   write_degree_one_2_sliceable_sets<4>();
   write_degree_one_2_sliceable_sets<5>();
-  write_degree_one_1_sliceable_sets<6>();
-  write_degree_one_1_sliceable_sets_only_usr<7>();
+  write_degree_one_2_sliceable_sets_out_of_core<6>();
+  write_degree_one_1_sliceable_sets_out_of_core<7>();
 
   write_degree_two_1_sliceable_sets<2>();
   write_degree_two_1_sliceable_sets<3>();
@@ -0,0 +1,81 @@
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bitset_comparator.hpp"
+#include "edge.hpp"
+#include "pairwise_kernel.h"
+#include "sliceable_set.hpp"
+
+using namespace ncube;
+
+/**
+ *  Returns random sliceable sets of the n-cube in which every edge is
+ *  contained with the given probability.
+ **/
+template <int32_t N>
+std::vector<sliceable_set_t<N>> random_sets(std::mt19937_64& generator,
+                                            std::size_t num_sets,
+                                            double density) {
+  std::bernoulli_distribution contains(density);
+  std::vector<sliceable_set_t<N>> sets(num_sets);
+  for (auto& ss : sets) {
+    for (int32_t e = 0; e < num_edges(N); ++e) {
+      ss[e] = contains(generator);
+    }
+  }
+  return sets;
+}
+
+/**
+ *  Compares the C kernel on padded records with pairwise_unions_slice_cube on
+ *  random lists of sliceable sets of the n-cube, whose unions slice all edges
+ *  in some cases and not in others, and checks that padded files read back
+ *  unchanged. Returns the number of mismatches.
+ **/
+template <int32_t N>
+int64_t validate_pairwise_kernel(const std::filesystem::path& dir) {
+  std::mt19937_64 generator(N);
+  int64_t num_checks = 0, num_slicing = 0, num_mismatches = 0;
+  for (const double density : {0.5, 0.7, 0.8, 0.9}) {
+    for (const std::size_t num_sets : {1, 10, 100, 1000}) {
+      const auto sets_1 = random_sets<N>(generator, num_sets, density);
+      auto sets_2 = random_sets<N>(generator, num_sets, density);
+      std::sort(sets_2.begin(), sets_2.end());
+      const auto records_1 = to_padded_records<N>(sets_1);
+      const auto records_2 = to_padded_records<N>(sets_2);
+      const bool expected = pairwise_unions_slice_cube<N>(sets_1, sets_2);
+      const bool actual = pairwise_unions_slice_cube_padded(
+          records_1.data(), sets_1.size(), records_2.data(), sets_2.size(), N);
+      num_checks += 1;
+      num_slicing += expected;
+      num_mismatches += expected != actual;
+    }
+  }
+  const auto sets = random_sets<N>(generator, 100, 0.5);
+  const auto path = dir / (std::to_string(N) + "_validate.pad");
+  write_to_padded_file<N>(sets, path);
+  num_mismatches += read_from_padded_file<N>(path) != sets;
+  num_mismatches += std::filesystem::file_size(path) !=
+                    sets.size() * padded_record_bytes(N);
+  std::filesystem::remove(path);
+  std::cout << N << "-cube: " << num_checks << " scans (" << num_slicing
+            << " slicing), " << num_mismatches << " mismatches" << std::endl;
+  return num_mismatches;
+}
+
+int main() {
+  const auto dir = std::filesystem::temp_directory_path();
+  int64_t num_mismatches = 0;
+  num_mismatches += validate_pairwise_kernel<2>(dir);
+  num_mismatches += validate_pairwise_kernel<3>(dir);
+  num_mismatches += validate_pairwise_kernel<4>(dir);
+  num_mismatches += validate_pairwise_kernel<5>(dir);
+  num_mismatches += validate_pairwise_kernel<6>(dir);
+  num_mismatches += validate_pairwise_kernel<7>(dir);
+  return num_mismatches == 0 ? 0 : 1;
+}
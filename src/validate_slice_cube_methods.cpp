@@ -0,0 +1,84 @@
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "complex.hpp"
+#include "edge.hpp"
+#include "low_weight.hpp"
+#include "slice_cube.hpp"
+#include "sliceable_set.hpp"
+#include "thread_pool.hpp"
+
+using namespace ncube;
+
+/* The number of local search steps per thread for the upper bounds. */
+constexpr uint64_t validation_upper_bound_steps = uint64_t{1} << 16;
+
+/**
+ *  Compares the smallest k found by every method of slice_cube_engine, and by
+ *  slice_cube_layered after searching for an upper bound, with the one found
+ *  by slice_cube_layered for a family given by its unique symmetric
+ *  representatives. Returns the number of mismatches.
+ **/
+template <int32_t N>
+int64_t validate_methods(const std::string& family,
+                         const std::vector<sliceable_set_t<N>>& usr,
+                         const edge_lexicon_t<N>& edges) {
+  const auto expected = slice_cube_min<N>(usr, edges, slice_cube_layered);
+  std::cout << N << "-cube, " << family << ": "
+            << slice_cube_method_name(slice_cube_layered) << " " << expected;
+  int64_t num_mismatches = 0;
+  for (const auto method : {slice_cube_cover_search, slice_cube_fused}) {
+    const auto k = slice_cube_min<N>(usr, edges, method);
+    std::cout << ", " << slice_cube_method_name(method) << " " << k;
+    num_mismatches += k != expected;
+  }
+  // the search ends at an upper bound found by local search
+  const auto k = slice_cube_min<N>(usr, edges, slice_cube_layered, nullptr,
+                                   validation_upper_bound_steps);
+  std::cout << ", upper bound " << k;
+  num_mismatches += k != expected;
+  std::cout << std::endl;
+  return num_mismatches;
+}
+
+/**
+ *  Validates all methods on the degree one, one weight and low weight families
+ *  of the n-cube. Returns the number of mismatches.
+ **/
+template <int32_t N>
+int64_t validate_slice_cube_methods() {
+  const auto& edges = compute_edges<N>();
+  int64_t num_mismatches = 0;
+  const auto complexes = compute_complexes<N>(is_complex_degree_one<N>);
+  num_mismatches += validate_methods<N>(
+      "degree one", complexes_to_usr<N>(complexes, edges), edges);
+  for (int32_t max = 1; max <= N; ++max) {
+    std::vector<int32_t> thresholds(static_cast<std::size_t>(max));
+    for (int32_t t = 0; t < max; ++t) {
+      thresholds[static_cast<std::size_t>(t)] = t;
+    }
+    const auto mss = compute_one_weight_mss<N>(thresholds, edges);
+    num_mismatches += validate_methods<N>(
+        "one weight, thresholds < " + std::to_string(max),
+        reduce_to_usr<N>(mss, edges), edges);
+  }
+  for (int32_t max = 1; max <= 2; ++max) {
+    const auto mss = compute_low_weight_mss<N>(max, edges);
+    num_mismatches += validate_methods<N>(
+        "low weight, max " + std::to_string(max),
+        reduce_to_usr<N>(mss, edges), edges);
+  }
+  return num_mismatches;
+}
+
+int main(int argc, char* argv[]) {
+  configure_threads(argc, argv);
+  int64_t num_mismatches = 0;
+  num_mismatches += validate_slice_cube_methods<2>();
+  num_mismatches += validate_slice_cube_methods<3>();
+  num_mismatches += validate_slice_cube_methods<4>();
+  std::cout << num_mismatches << " mismatches" << std::endl;
+  return num_mismatches == 0 ? 0 : 1;
+}